@@ -0,0 +1,109 @@
+#include <AsyncLogging.h>
+
+AsyncLogging::AsyncLogging(LoggingBase& sink) : sink_(sink) {
+    // Slot i is free for the producer that claims position i.
+    for (uint32_t i = 0; i < ASYNC_LOGGING_SLOTS; ++i) {
+        slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+AsyncLogging::~AsyncLogging() {
+#if defined(ESP32)
+    end();
+#endif
+}
+
+bool AsyncLogging::enqueue(const char* data, size_t len, bool newline, LogLevel level) {
+    // Bounded MPMC queue (Vyukov): a slot whose sequence equals the claimed
+    // position is free; the producer publishes it by storing position + 1.
+    uint32_t pos = head_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots_[pos & (ASYNC_LOGGING_SLOTS - 1)];
+        uint32_t seq = slot->seq.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // Ring full: drop instead of waiting for the sink.
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    if (len > ASYNC_LOGGING_SLOT_SIZE) len = ASYNC_LOGGING_SLOT_SIZE;
+    memcpy(slot->data, data, len);
+    slot->len = (uint16_t)len;
+    slot->newline = newline;
+    slot->level = level;
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+#if defined(ESP32)
+    notifiers_.fetch_add(1, std::memory_order_seq_cst);
+    TaskHandle_t task = task_.load(std::memory_order_seq_cst);
+    if (task) xTaskNotifyGive(task);
+    notifiers_.fetch_sub(1, std::memory_order_release);
+#endif
+    return true;
+}
+
+size_t AsyncLogging::drain() {
+    size_t n = 0;
+    for (;;) {
+        Slot& slot = slots_[tail_ & (ASYNC_LOGGING_SLOTS - 1)];
+        uint32_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq != tail_ + 1) break; // empty (or producer still copying)
+
+        if (slot.level != LogLevel::None) sink_.log(slot.level, slot.data, slot.len);
+        else if (slot.newline)            sink_.writeln(slot.data, slot.len);
+        else                              sink_.write(slot.data, slot.len);
+
+        // Hand the slot back to producers one lap ahead.
+        slot.seq.store(tail_ + ASYNC_LOGGING_SLOTS, std::memory_order_release);
+        ++tail_;
+        ++n;
+    }
+    return n;
+}
+
+#if defined(ESP32)
+bool AsyncLogging::begin(UBaseType_t priority, BaseType_t core, uint32_t stackSize) {
+    if (task_.load()) return true;
+    stop_.store(false);
+    stopped_.store(false);
+    TaskHandle_t task = nullptr;
+    if (xTaskCreatePinnedToCore(drainTask, "asyncLog", stackSize, this, priority, &task, core) != pdPASS) {
+        return false;
+    }
+    task_.store(task);
+    return true;
+}
+
+void AsyncLogging::end() {
+    TaskHandle_t task = task_.exchange(nullptr, std::memory_order_seq_cst);
+    if (!task) return;
+    // Producers that loaded the handle before the exchange finish notifying.
+    while (notifiers_.load(std::memory_order_seq_cst) != 0) vTaskDelay(1);
+    // The task must leave on its own: deleting it from here could stop it
+    // inside a sink call, holding the sink's lock.
+    stop_.store(true, std::memory_order_release);
+    xTaskNotifyGive(task);
+    while (!stopped_.load(std::memory_order_acquire)) vTaskDelay(1);
+}
+
+void AsyncLogging::drainTask(void* arg) {
+    auto* self = static_cast<AsyncLogging*>(arg);
+    while (!self->stop_.load(std::memory_order_acquire)) {
+        // Producers notify on every message; the timeout also picks up
+        // messages queued before the task handle was published.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+        self->drain();
+    }
+    self->drain();
+    // Last access to self: end() may return and the object go away.
+    self->stopped_.store(true, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
+#endif
@@ -0,0 +1,97 @@
+#ifndef ASYNC_LOGGING_H
+#define ASYNC_LOGGING_H
+
+#include <LoggingBase.h>
+#include <atomic>
+
+// --- Configuration -----------------------------------------------------------
+#ifndef ASYNC_LOGGING_SLOT_SIZE
+  // Longest message stored per slot; longer messages are truncated.
+  #define ASYNC_LOGGING_SLOT_SIZE 128
+#endif
+#ifndef ASYNC_LOGGING_SLOTS
+  // Number of queued messages; must be a power of two.
+  #define ASYNC_LOGGING_SLOTS 32
+#endif
+
+/**
+ * Non-blocking logging backend.
+ *
+ * print/println copy the message into a lock-free multi-producer ring and
+ * return immediately; a drain task writes the queued messages to the real
+ * sink. The caller never waits for the sink: when the ring is full the
+ * message is dropped and counted (see dropped()).
+ *
+ * Usage:
+ *   static SerialLogging serialSink;
+ *   static AsyncLogging  asyncLogger(serialSink);
+ *   void setup() {
+ *     asyncLogger.begin();
+ *     setLogger(&asyncLogger);
+ *   }
+ *
+ * Without FreeRTOS (e.g. a host build) begin() is not available; call
+ * drain() periodically from a single consumer instead.
+ */
+class AsyncLogging : public LoggingBase {
+public:
+    explicit AsyncLogging(LoggingBase& sink);
+    ~AsyncLogging();
+
+#if defined(ESP32)
+    // Starts the drain task. Messages logged before are queued (or dropped).
+    bool begin(UBaseType_t priority = 1, BaseType_t core = tskNO_AFFINITY,
+               uint32_t stackSize = 3072);
+    // Stops the drain task after it has written what is queued and returns
+    // once it is gone. Not from the sink (that is the drain task itself).
+    void end();
+#endif
+
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { enqueue(msg.c_str(), msg.length(), false); }
+    void println(const String& msg) override { enqueue(msg.c_str(), msg.length(), true); }
+    void write(const char* data, size_t len) override { enqueue(data, len, false); }
+    void writeln(const char* data, size_t len) override { enqueue(data, len, true); }
+    void log(LogLevel level, const char* data, size_t len) override { enqueue(data, len, true, level); }
+    bool enabled(LogLevel level) const override { return sink_.enabled(level); }
+
+    // Writes all queued messages to the sink. Single consumer only: do not
+    // call while the drain task is running. Returns the number written.
+    size_t drain();
+
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    static_assert((ASYNC_LOGGING_SLOTS & (ASYNC_LOGGING_SLOTS - 1)) == 0,
+                  "ASYNC_LOGGING_SLOTS must be a power of two");
+
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        uint16_t len;
+        bool newline;
+        LogLevel level;   // None for untagged print/println
+        char data[ASYNC_LOGGING_SLOT_SIZE];
+    };
+
+    bool enqueue(const char* data, size_t len, bool newline, LogLevel level = LogLevel::None);
+
+    LoggingBase& sink_;
+    Slot slots_[ASYNC_LOGGING_SLOTS];
+    std::atomic<uint32_t> head_{0};   // next position claimed by a producer
+    uint32_t tail_ = 0;               // next position read by the consumer
+    std::atomic<uint32_t> dropped_{0};
+
+#if defined(ESP32)
+    static void drainTask(void* arg);
+    std::atomic<TaskHandle_t> task_{nullptr};
+    // Producers between loading task_ and notifying it; end() waits for
+    // them so nobody notifies a deleted task.
+    std::atomic<uint32_t> notifiers_{0};
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> stopped_{false};
+#endif
+};
+
+#endif
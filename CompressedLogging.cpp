@@ -0,0 +1,144 @@
+#include <CompressedLogging.h>
+
+#if defined(ESP32)
+#include <threadSafeArduino.h>
+#define COMPRESSED_LOG_LOCK() threadSafe::detail::LockGuard _compressedLogGuard(lock_)
+#else
+#define COMPRESSED_LOG_LOCK() do {} while (0)
+#endif
+
+static const uint8_t kFrameCompressed = 0xC5;
+static const uint8_t kFrameStored = 0xC4;
+static const size_t kMinMatch = 3;
+static const size_t kMaxMatch = kMinMatch + 255;
+static const size_t kWindow = 256;
+static const uint16_t kNoPos = 0xffff;
+
+CompressedLogging::CompressedLogging(LoggingBase& inner) : inner_(inner) {
+#if defined(ESP32)
+    lock_ = threadSafe::detail::createMutex();
+#endif
+}
+
+CompressedLogging::~CompressedLogging() {
+    flush();
+}
+
+void CompressedLogging::write(const char* data, size_t len) {
+    COMPRESSED_LOG_LOCK();
+    append(data, len);
+}
+
+void CompressedLogging::writeln(const char* data, size_t len) {
+    COMPRESSED_LOG_LOCK();
+    append(data, len);
+    append("\n", 1);
+}
+
+void CompressedLogging::append(const char* data, size_t len) {
+    if (blockLen_ > 0 && millis() - blockStartMs_ >= COMPRESSED_LOG_FLUSH_MS) flushLocked();
+    bytesIn_ += len;
+    while (len > 0) {
+        if (blockLen_ == 0) blockStartMs_ = millis();
+        size_t n = sizeof(block_) - blockLen_;
+        if (n > len) n = len;
+        memcpy(block_ + blockLen_, data, n);
+        blockLen_ += n;
+        data += n;
+        len -= n;
+        if (blockLen_ == sizeof(block_)) flushLocked();
+    }
+}
+
+void CompressedLogging::flush() {
+    COMPRESSED_LOG_LOCK();
+    flushLocked();
+}
+
+void CompressedLogging::flushLocked() {
+    if (blockLen_ == 0) return;
+    uint32_t t0 = micros();
+    size_t n = compressBlock(block_, blockLen_, frame_ + 5, blockLen_, head_, prev_);
+    compressMicros_ += micros() - t0;
+
+    if (n == 0) {
+        frame_[0] = kFrameStored;
+        memcpy(frame_ + 5, block_, blockLen_);
+        n = blockLen_;
+    } else {
+        frame_[0] = kFrameCompressed;
+    }
+    frame_[1] = (uint8_t)blockLen_;
+    frame_[2] = (uint8_t)(blockLen_ >> 8);
+    frame_[3] = (uint8_t)n;
+    frame_[4] = (uint8_t)(n >> 8);
+    blockLen_ = 0;
+    bytesOut_ += 5 + n;
+    inner_.write(reinterpret_cast<const char*>(frame_), 5 + n);
+}
+
+static inline uint8_t hash3(const uint8_t* p) {
+    return (uint8_t)((p[0] << 5) ^ (p[1] << 2) ^ p[2] ^ (p[0] >> 3));
+}
+
+size_t CompressedLogging::compressBlock(const uint8_t* in, size_t len, uint8_t* out, size_t cap,
+                                        uint16_t* head, uint16_t* prev) {
+    for (size_t i = 0; i < 256; ++i) head[i] = kNoPos;
+
+    size_t o = 0;
+    size_t flagPos = 0;
+    uint8_t bit = 0;
+    size_t i = 0;
+    while (i < len) {
+        // Worst case per item: a new flag byte plus a two-byte match.
+        if (o + 3 > cap) return 0;
+        if (bit == 0) {
+            flagPos = o++;
+            out[flagPos] = 0;
+        }
+
+        // Longest match within the window along the hash chain.
+        size_t bestLen = 0;
+        size_t bestDist = 0;
+        if (i + kMinMatch <= len) {
+            size_t limit = len - i < kMaxMatch ? len - i : kMaxMatch;
+            uint16_t cand = head[hash3(in + i)];
+            for (int chain = 0; cand != kNoPos && i - cand <= kWindow &&
+                                chain < COMPRESSED_LOG_MAX_CHAIN; ++chain) {
+                const uint8_t* a = in + cand;
+                const uint8_t* b = in + i;
+                if (a[bestLen] == b[bestLen]) {
+                    size_t m = 0;
+                    while (m < limit && a[m] == b[m]) ++m;
+                    if (m > bestLen) {
+                        bestLen = m;
+                        bestDist = i - cand;
+                        if (m == limit) break;
+                    }
+                }
+                cand = prev[cand];
+            }
+        }
+
+        size_t step;
+        if (bestLen >= kMinMatch) {
+            out[flagPos] |= (uint8_t)(1 << bit);
+            out[o++] = (uint8_t)(bestDist - 1);
+            out[o++] = (uint8_t)(bestLen - kMinMatch);
+            step = bestLen;
+        } else {
+            out[o++] = in[i];
+            step = 1;
+        }
+        bit = (bit + 1) & 7;
+
+        // Index every position covered, so later matches can start inside.
+        for (size_t end = i + step; i < end; ++i) {
+            if (i + kMinMatch > len) continue;
+            uint8_t h = hash3(in + i);
+            prev[i] = head[h];
+            head[h] = (uint16_t)i;
+        }
+    }
+    return o < len ? o : 0;
+}
@@ -0,0 +1,94 @@
+#ifndef COMPRESSED_LOGGING_H
+#define COMPRESSED_LOGGING_H
+
+#include <LoggingBase.h>
+
+#ifndef COMPRESSED_LOG_BLOCK_SIZE
+  // Uncompressed bytes per block (max 65535); matches never cross blocks.
+  #define COMPRESSED_LOG_BLOCK_SIZE 1024
+#endif
+#ifndef COMPRESSED_LOG_MAX_CHAIN
+  // Match candidates tried per position; trades ratio for CPU time.
+  #define COMPRESSED_LOG_MAX_CHAIN 16
+#endif
+#ifndef COMPRESSED_LOG_FLUSH_MS
+  // A partially filled block is compressed once it is this old (checked on
+  // the next log call) or when flush() is called.
+  #define COMPRESSED_LOG_FLUSH_MS 5000
+#endif
+
+/**
+ * Block compression stage for byte-limited sinks (flash ring, network).
+ *
+ * Output is collected into COMPRESSED_LOG_BLOCK_SIZE blocks, each compressed
+ * on its own with a small-window LZSS (256-byte window, matches of 3..258
+ * bytes) and passed to the wrapped backend as one binary write() per frame:
+ *
+ *   0xC5 rawLen:u16le payloadLen:u16le payload    compressed block
+ *   0xC4 rawLen:u16le rawLen:u16le     raw bytes  stored (did not shrink)
+ *
+ * The payload is a sequence of groups: a flag byte, then 8 items (fewer at
+ * the end), LSB first; a 0 bit is one literal byte, a 1 bit a match of two
+ * bytes (distance - 1, length - 3). RAM use is fixed: about 4.6 KB with the
+ * default block size, all inside the object.
+ *
+ *   static FlashRingLogging flashLog("/littlefs/log.lz", 64 * 1024);
+ *   static CompressedLogging packedLog(flashLog);
+ *   setLogger(&packedLog);
+ *
+ * The sink must be binary-safe. tools/logdecompress.py turns a captured
+ * stream back into text and reports the achieved ratio.
+ */
+class CompressedLogging : public LoggingBase {
+public:
+    explicit CompressedLogging(LoggingBase& inner);
+    ~CompressedLogging();
+
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override;
+    void writeln(const char* data, size_t len) override;
+    bool enabled(LogLevel level) const override { return inner_.enabled(level); }
+
+    // Compresses and forwards the pending partial block.
+    void flush();
+
+    // Totals since construction: text in, frame bytes out, time spent
+    // compressing.
+    uint32_t bytesIn() const { return bytesIn_; }
+    uint32_t bytesOut() const { return bytesOut_; }
+    uint32_t compressMicros() const { return compressMicros_; }
+
+    // Compresses `len` bytes of `in` into `out` (capacity `cap`); returns the
+    // payload size, or 0 if it would not be smaller than the input. `head`
+    // and `prev` are scratch tables of 256 and `len` entries.
+    static size_t compressBlock(const uint8_t* in, size_t len, uint8_t* out, size_t cap,
+                                uint16_t* head, uint16_t* prev);
+
+private:
+    static_assert(COMPRESSED_LOG_BLOCK_SIZE <= 65535, "block length must fit a u16");
+
+    void append(const char* data, size_t len);
+    void flushLocked();
+
+    LoggingBase& inner_;
+    uint8_t block_[COMPRESSED_LOG_BLOCK_SIZE];
+    size_t blockLen_ = 0;
+    uint32_t blockStartMs_ = 0;
+    uint8_t frame_[5 + COMPRESSED_LOG_BLOCK_SIZE];
+    uint16_t head_[256];
+    uint16_t prev_[COMPRESSED_LOG_BLOCK_SIZE];
+
+    uint32_t bytesIn_ = 0;
+    uint32_t bytesOut_ = 0;
+    uint32_t compressMicros_ = 0;
+
+#if defined(ESP32)
+    SemaphoreHandle_t lock_;
+#endif
+};
+
+#endif
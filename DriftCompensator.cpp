@@ -0,0 +1,63 @@
+#include <DriftCompensator.h>
+
+void DriftCompensator::reset() {
+    head_ = 0;
+    count_ = 0;
+    locked_ = false;
+    ppb_ = 0;
+    intercept_ = 0;
+}
+
+bool DriftCompensator::addSample(uint64_t monoUs, int64_t offsetUs) {
+    bool fits = true;
+    if (count_ > 0) {
+        const Sample& last = samples_[(head_ + DRIFT_MAX_SAMPLES - 1) % DRIFT_MAX_SAMPLES];
+        // Where the current line (or the last offset, before lock) puts it.
+        double predicted = (double)last.offsetUs;
+        if (locked_) {
+            predicted = intercept_ + (double)(int64_t)(monoUs - last.monoUs) * ppb_ / 1e9;
+        }
+        double residual = (double)offsetUs - predicted;
+        if (monoUs <= last.monoUs || residual > DRIFT_RESTART_MS * 1000.0 ||
+            residual < -DRIFT_RESTART_MS * 1000.0) {
+            reset();
+            fits = false;
+        }
+    }
+    samples_[head_] = { monoUs, offsetUs };
+    head_ = (head_ + 1) % DRIFT_MAX_SAMPLES;
+    if (count_ < DRIFT_MAX_SAMPLES) ++count_;
+    fit();
+    return fits;
+}
+
+void DriftCompensator::fit() {
+    const Sample& newest = samples_[(head_ + DRIFT_MAX_SAMPLES - 1) % DRIFT_MAX_SAMPLES];
+    const Sample& oldest = samples_[(head_ + DRIFT_MAX_SAMPLES - count_) % DRIFT_MAX_SAMPLES];
+    if (count_ < 2 || newest.monoUs - oldest.monoUs < (uint64_t)DRIFT_MIN_SPAN_S * 1000000) {
+        intercept_ = (double)newest.offsetUs;
+        return;
+    }
+
+    // Least squares in coordinates relative to the newest sample, so the
+    // intercept is the fitted offset now and the sums stay well conditioned.
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (uint8_t i = 0; i < count_; ++i) {
+        const Sample& s = samples_[(head_ + DRIFT_MAX_SAMPLES - 1 - i) % DRIFT_MAX_SAMPLES];
+        double x = -(double)(newest.monoUs - s.monoUs) / 1e6;   // seconds
+        double y = (double)(s.offsetUs - newest.offsetUs);      // microseconds
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    double n = count_;
+    double den = n * sxx - sx * sx;
+    if (den <= 0) return;
+    double slope = (n * sxy - sx * sy) / den;                   // us/s = ppm
+    if (slope > DRIFT_MAX_PPM) slope = DRIFT_MAX_PPM;
+    if (slope < -DRIFT_MAX_PPM) slope = -DRIFT_MAX_PPM;
+    ppb_ = (int32_t)(slope * 1000.0);
+    intercept_ = (double)newest.offsetUs + (sy - slope * sx) / n;
+    locked_ = true;
+}
@@ -0,0 +1,75 @@
+#ifndef DRIFT_COMPENSATOR_H
+#define DRIFT_COMPENSATOR_H
+
+#include <Arduino.h>
+
+#ifndef DRIFT_MAX_SAMPLES
+  // Sync samples kept for the frequency fit.
+  #define DRIFT_MAX_SAMPLES 8
+#endif
+#ifndef DRIFT_MIN_SPAN_S
+  // Samples must span at least this long before an estimate is used;
+  // shorter baselines turn network jitter into large frequency errors.
+  #define DRIFT_MIN_SPAN_S 300
+#endif
+#ifndef DRIFT_MAX_PPM
+  // Estimates beyond this are clamped (crystals are spec'd at tens of ppm).
+  #define DRIFT_MAX_PPM 500
+#endif
+#ifndef DRIFT_RESTART_MS
+  // A sample this far off the fitted line is taken as a reference time
+  // change rather than drift; the estimate starts over from it.
+  #define DRIFT_RESTART_MS 128
+#endif
+
+/**
+ * Frequency error estimate of the local oscillator.
+ *
+ * Each sync contributes (monotonic time, reference - monotonic). A least
+ * squares line through the last DRIFT_MAX_SAMPLES samples gives the rate at
+ * which the local clock drifts; the time provider scales elapsed monotonic
+ * time by it on every read, so the clock stays close to the reference between
+ * syncs and syncs can be spaced further apart.
+ *
+ * NtpTimeProvider is the only provider wired to it so far; another time
+ * source with occasional reference samples can use it the same way:
+ *
+ *   DriftCompensator drift;
+ *   drift.addSample(mono, refUs - (int64_t)mono);   // per sync
+ *   now = base + elapsed + drift.correction(elapsed);
+ */
+class DriftCompensator {
+public:
+    // Returns false if the sample did not fit the current estimate and the
+    // history was restarted from it.
+    bool addSample(uint64_t monoUs, int64_t offsetUs);
+    void reset();
+
+    // True once the samples span DRIFT_MIN_SPAN_S.
+    bool locked() const { return locked_; }
+    // Rate correction in parts per billion; 0 until locked.
+    int32_t ppb() const { return locked_ ? ppb_ : 0; }
+    float ppm() const { return ppb() / 1000.0f; }
+    uint8_t samples() const { return count_; }
+
+    // Microseconds to add to `elapsedUs` of monotonic time.
+    int64_t correction(uint64_t elapsedUs) const {
+        return (int64_t)elapsedUs * ppb() / 1000000000;
+    }
+
+private:
+    void fit();
+
+    struct Sample {
+        uint64_t monoUs;
+        int64_t offsetUs;
+    };
+    Sample samples_[DRIFT_MAX_SAMPLES];
+    uint8_t head_ = 0;      // next slot to write
+    uint8_t count_ = 0;
+    bool locked_ = false;
+    int32_t ppb_ = 0;
+    double intercept_ = 0;  // fitted offset at the newest sample (us)
+};
+
+#endif
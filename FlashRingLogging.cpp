@@ -0,0 +1,246 @@
+#include <FlashRingLogging.h>
+#include <unistd.h>
+
+#if defined(ESP32)
+#include <threadSafeArduino.h>
+#define FLASH_LOG_LOCK() threadSafe::detail::LockGuard _flashLogGuard(lock_)
+#else
+#define FLASH_LOG_LOCK() std::lock_guard<std::mutex> _flashLogGuard(lock_)
+#endif
+
+static const uint32_t kFlashLogMagic = 0x53474f4c; // "LOGS"
+
+static const void* currentTask() {
+#if defined(ESP32)
+    return xTaskGetCurrentTaskHandle();
+#else
+    static thread_local char marker;
+    return &marker;
+#endif
+}
+
+FlashRingLogging::FlashRingLogging(const char* path, uint32_t capacity)
+    : path_(path), capacity_(capacity), segmentSize_(capacity / FLASH_LOG_SEGMENTS) {
+#if defined(ESP32)
+    // Each segment needs room for data; begin() also refuses this.
+    configASSERT(segmentSize_ > 0);
+    lock_ = threadSafe::detail::createMutex();
+#endif
+}
+
+FlashRingLogging::~FlashRingLogging() {
+    end();
+}
+
+void FlashRingLogging::segmentPath(uint32_t seq, char* out, size_t cap) const {
+    snprintf(out, cap, "%s.%u", path_, (unsigned)(seq % FLASH_LOG_SEGMENTS));
+}
+
+bool FlashRingLogging::begin() {
+    FLASH_LOG_LOCK();
+    if (file_) return true;
+    if (segmentSize_ == 0) return false;
+
+    // Read every segment header; the newest valid one is the head.
+    bool valid[FLASH_LOG_SEGMENTS] = {false};
+    uint32_t seqs[FLASH_LOG_SEGMENTS] = {0};
+    bool found = false;
+    for (uint32_t i = 0; i < FLASH_LOG_SEGMENTS; ++i) {
+        char name[96];
+        segmentPath(i, name, sizeof(name));
+        FILE* f = fopen(name, "rb");
+        if (!f) continue;
+        SegmentHeader h;
+        if (fread(&h, sizeof(h), 1, f) == 1 && h.magic == kFlashLogMagic &&
+            h.segmentSize == segmentSize_ && h.seq % FLASH_LOG_SEGMENTS == i) {
+            fseek(f, 0, SEEK_END);
+            long end = ftell(f);
+            long len = end - (long)sizeof(h);
+            lens_[i] = len < 0 ? 0 : len > (long)segmentSize_ ? segmentSize_ : (uint32_t)len;
+            valid[i] = true;
+            seqs[i] = h.seq;
+            if (!found || (int32_t)(h.seq - seq_) > 0) seq_ = h.seq;
+            found = true;
+        }
+        fclose(f);
+    }
+    if (!found) return startSegment(0);
+
+    // Keep the unbroken run of segments ending at the newest.
+    oldest_ = seq_;
+    while (seq_ - oldest_ + 1 < FLASH_LOG_SEGMENTS && oldest_ > 0) {
+        uint32_t i = (oldest_ - 1) % FLASH_LOG_SEGMENTS;
+        if (!valid[i] || seqs[i] != oldest_ - 1) break;
+        --oldest_;
+    }
+    for (uint32_t s = seq_ + 1; s < oldest_ + FLASH_LOG_SEGMENTS; ++s) {
+        lens_[s % FLASH_LOG_SEGMENTS] = 0;
+    }
+    dropped_ = oldest_ > 0;
+
+    char name[96];
+    segmentPath(seq_, name, sizeof(name));
+    file_ = fopen(name, "ab");
+    return file_ != nullptr;
+}
+
+// Truncates the file for `seq` and writes its header; it becomes the head.
+bool FlashRingLogging::startSegment(uint32_t seq) {
+    if (file_) fclose(file_);
+    char name[96];
+    segmentPath(seq, name, sizeof(name));
+    file_ = fopen(name, "wb");
+    if (!file_) return false;
+    SegmentHeader h = { kFlashLogMagic, seq, segmentSize_ };
+    if (fwrite(&h, sizeof(h), 1, file_) != 1) {
+        fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    if (seq - oldest_ + 1 > FLASH_LOG_SEGMENTS) {
+        oldest_ = seq - FLASH_LOG_SEGMENTS + 1;
+        dropped_ = true;
+    }
+    seq_ = seq;
+    lens_[seq % FLASH_LOG_SEGMENTS] = 0;
+    return true;
+}
+
+void FlashRingLogging::end() {
+    FLASH_LOG_LOCK();
+    if (!file_) return;
+    flushLocked();
+    fclose(file_);
+    file_ = nullptr;
+}
+
+uint32_t FlashRingLogging::size() const {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < FLASH_LOG_SEGMENTS; ++i) n += lens_[i];
+    return n;
+}
+
+void FlashRingLogging::write(const char* data, size_t len) {
+    if (dumper_.load(std::memory_order_relaxed) == currentTask()) return;
+    FLASH_LOG_LOCK();
+    append(data, len);
+}
+
+void FlashRingLogging::writeln(const char* data, size_t len) {
+    // Output that dump() routes back here (e.g. through a TeeLogging) would
+    // deadlock on the lock it holds; drop it instead.
+    if (dumper_.load(std::memory_order_relaxed) == currentTask()) return;
+    FLASH_LOG_LOCK();
+    append(data, len);
+    append("\n", 1);
+}
+
+void FlashRingLogging::append(const char* data, size_t len) {
+    if (!file_) return;
+    if (pageLen_ > 0 && millis() - pageStartMs_ >= FLASH_LOG_FLUSH_MS) flushLocked();
+    while (len > 0) {
+        if (pageLen_ == 0) pageStartMs_ = millis();
+        size_t n = sizeof(page_) - pageLen_;
+        if (n > len) n = len;
+        memcpy(page_ + pageLen_, data, n);
+        pageLen_ += n;
+        data += n;
+        len -= n;
+        if (pageLen_ == sizeof(page_)) flushLocked();
+    }
+}
+
+void FlashRingLogging::flush() {
+    FLASH_LOG_LOCK();
+    flushLocked();
+}
+
+void FlashRingLogging::flushLocked() {
+    if (!file_ || pageLen_ == 0) return;
+    const char* p = page_;
+    size_t left = pageLen_;
+    pageLen_ = 0;
+    while (left > 0) {
+        uint32_t& len = lens_[seq_ % FLASH_LOG_SEGMENTS];
+        if (len >= segmentSize_) {
+            fflush(file_);
+            fsync(fileno(file_));
+            if (!startSegment(seq_ + 1)) return;
+            continue;
+        }
+        size_t n = segmentSize_ - len;
+        if (n > left) n = left;
+        n = fwrite(p, 1, n, file_);
+        if (n == 0) break;
+        p += n;
+        left -= n;
+        len += n;
+    }
+    fflush(file_);
+    fsync(fileno(file_));
+}
+
+void FlashRingLogging::clear() {
+    FLASH_LOG_LOCK();
+    if (!file_) return;
+    fclose(file_);
+    file_ = nullptr;
+    for (uint32_t i = 0; i < FLASH_LOG_SEGMENTS; ++i) {
+        char name[96];
+        segmentPath(i, name, sizeof(name));
+        remove(name);
+        lens_[i] = 0;
+    }
+    pageLen_ = 0;
+    oldest_ = 0;
+    dropped_ = false;
+    startSegment(0);
+}
+
+void FlashRingLogging::dump(LoggingBase& out) {
+    FLASH_LOG_LOCK();
+    if (!file_) return;
+    flushLocked();
+    dumper_.store(currentTask(), std::memory_order_relaxed);
+
+    char chunk[FLASH_LOG_PAGE_SIZE];
+    char line[LOGGING_LINE_BUFFER_SIZE];
+    size_t lineLen = 0;
+    // With older output dropped the oldest line is usually cut; skip to its end.
+    bool skipping = dropped_;
+
+    for (uint32_t seq = oldest_; (int32_t)(seq_ - seq) >= 0; ++seq) {
+        char name[96];
+        segmentPath(seq, name, sizeof(name));
+        FILE* f = fopen(name, "rb");
+        if (!f) continue;
+        uint32_t left = lens_[seq % FLASH_LOG_SEGMENTS];
+        fseek(f, sizeof(SegmentHeader), SEEK_SET);
+        while (left > 0) {
+            size_t n = left < sizeof(chunk) ? left : sizeof(chunk);
+            n = fread(chunk, 1, n, f);
+            if (n == 0) break;
+            left -= n;
+            for (size_t i = 0; i < n; ++i) {
+                char c = chunk[i];
+                if (skipping) {
+                    skipping = c != '\n';
+                    continue;
+                }
+                if (c == '\n') {
+                    out.writeln(line, lineLen);
+                    lineLen = 0;
+                    continue;
+                }
+                if (lineLen == sizeof(line)) {
+                    out.write(line, lineLen);
+                    lineLen = 0;
+                }
+                line[lineLen++] = c;
+            }
+        }
+        fclose(f);
+    }
+    if (lineLen > 0) out.writeln(line, lineLen);
+    dumper_.store(nullptr, std::memory_order_relaxed);
+}
@@ -0,0 +1,112 @@
+#ifndef FLASH_RING_LOGGING_H
+#define FLASH_RING_LOGGING_H
+
+#include <LoggingBase.h>
+#include <stdio.h>
+#include <atomic>
+#if !defined(ESP32)
+#include <mutex>
+#endif
+
+#ifndef FLASH_LOG_PAGE_SIZE
+  // Write batch size; output is buffered until a page is full.
+  #define FLASH_LOG_PAGE_SIZE 256
+#endif
+#ifndef FLASH_LOG_FLUSH_MS
+  // A partially filled page is written once it is this old (checked on the
+  // next log call) or when flush() is called.
+  #define FLASH_LOG_FLUSH_MS 5000
+#endif
+#ifndef FLASH_LOG_SEGMENTS
+  // Files the ring is split into; when all are full the oldest is reused.
+  #define FLASH_LOG_SEGMENTS 4
+#endif
+
+/**
+ * Persistent log ring of bounded size on a flash file system.
+ *
+ * Uses stdio so the same code runs on the ESP32 VFS (mount LittleFS/SPIFFS
+ * first, e.g. LittleFS.begin() and path "/littlefs/log") and on a host
+ * build. The ring is FLASH_LOG_SEGMENTS files "<path>.0", "<path>.1", ...
+ * of capacity / FLASH_LOG_SEGMENTS bytes each. Output is only appended to
+ * the newest file; once all are full the oldest one is truncated and
+ * reused, dropping its lines.
+ *
+ * Flash file systems copy a whole block on an in-place write (LittleFS also
+ * rewrites everything after it in the file), so nothing is ever rewritten:
+ * each file starts with a small header holding its sequence number, written
+ * once when the file is started, and begin() finds the newest file by
+ * scanning those headers. Writes are batched into FLASH_LOG_PAGE_SIZE
+ * chunks.
+ *
+ *   static FlashRingLogging flashLog("/littlefs/log", 64 * 1024);
+ *   void setup() {
+ *     LittleFS.begin(true);
+ *     flashLog.begin();
+ *     flashLog.dump(*gLogger);   // previous run
+ *   }
+ */
+class FlashRingLogging : public LoggingBase {
+public:
+    FlashRingLogging(const char* path, uint32_t capacity);
+    ~FlashRingLogging();
+
+    // Reattaches to segments written with the same capacity, or starts a new
+    // ring. False if capacity < FLASH_LOG_SEGMENTS or on a file error.
+    bool begin();
+    void end();
+
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override;
+    void writeln(const char* data, size_t len) override;
+
+    // Appends the buffered page to the newest segment.
+    void flush();
+    // Streams the ring, oldest line first, to `out` (includes unflushed data).
+    // Anything the dumping task logs back into this ring meanwhile is dropped.
+    void dump(LoggingBase& out);
+    // Discards all content.
+    void clear();
+
+    uint32_t capacity() const { return capacity_; }
+    // Bytes currently kept, buffered page excluded.
+    uint32_t size() const;
+
+private:
+    struct SegmentHeader {
+        uint32_t magic;
+        uint32_t seq;           // the file's index is seq % FLASH_LOG_SEGMENTS
+        uint32_t segmentSize;
+    };
+
+    void append(const char* data, size_t len);
+    void flushLocked();
+    bool startSegment(uint32_t seq);
+    void segmentPath(uint32_t seq, char* out, size_t cap) const;
+
+    const char* path_;
+    uint32_t capacity_;
+    uint32_t segmentSize_;
+    FILE* file_ = nullptr;          // newest segment, opened for appending
+    uint32_t seq_ = 0;              // newest segment
+    uint32_t oldest_ = 0;           // oldest segment still kept
+    uint32_t lens_[FLASH_LOG_SEGMENTS] = {0};   // data bytes per file
+    bool dropped_ = false;          // older output was discarded
+
+    char page_[FLASH_LOG_PAGE_SIZE];
+    size_t pageLen_ = 0;
+    uint32_t pageStartMs_ = 0;
+    std::atomic<const void*> dumper_{nullptr};   // task inside dump()
+
+#if defined(ESP32)
+    SemaphoreHandle_t lock_;
+#else
+    std::mutex lock_;
+#endif
+};
+
+#endif
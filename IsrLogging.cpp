@@ -0,0 +1,80 @@
+#include <IsrLogging.h>
+#include <atomic>
+
+static_assert((ISR_LOG_SLOTS & (ISR_LOG_SLOTS - 1)) == 0,
+              "ISR_LOG_SLOTS must be a power of two");
+
+namespace {
+
+struct IsrRecord {
+    // Stored relative to the slot index (seq - index) so the zero-filled
+    // ring is already initialized: no constructor has to run before an
+    // interrupt that fires during static initialization can log.
+    std::atomic<uint32_t> seq;
+    const char* fmt;
+    uint32_t args[3];
+    uint32_t timestampUs;
+};
+
+// Same bounded MPMC scheme as AsyncLogging; kept separate so the ISR path
+// is plain code in IRAM with no calls into flash.
+IsrRecord _records[ISR_LOG_SLOTS];
+std::atomic<uint32_t> _head{0};
+uint32_t _tail = 0;
+std::atomic<uint32_t> _dropped{0};
+
+} // namespace
+
+bool IRAM_ATTR logFromIsr(const char* fmt, uint32_t a0, uint32_t a1, uint32_t a2) {
+    uint32_t pos = _head.load(std::memory_order_relaxed);
+    IsrRecord* r;
+    uint32_t idx;
+    for (;;) {
+        idx = pos & (ISR_LOG_SLOTS - 1);
+        r = &_records[idx];
+        int32_t diff = (int32_t)(r->seq.load(std::memory_order_acquire) + idx - pos);
+        if (diff == 0) {
+            if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = _head.load(std::memory_order_relaxed);
+        }
+    }
+    r->fmt = fmt;
+    r->args[0] = a0;
+    r->args[1] = a1;
+    r->args[2] = a2;
+    r->timestampUs = micros();
+    r->seq.store(pos + 1 - idx, std::memory_order_release);
+    return true;
+}
+
+size_t drainIsrLog(LoggingBase& out) {
+    size_t n = 0;
+    for (;;) {
+        uint32_t idx = _tail & (ISR_LOG_SLOTS - 1);
+        IsrRecord& r = _records[idx];
+        if (r.seq.load(std::memory_order_acquire) + idx != _tail + 1) break;
+
+        char buf[LOGGING_LINE_BUFFER_SIZE];
+        LogFormatter f(buf, sizeof(buf));
+        f << "[isr " << r.timestampUs << " us] ";
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+        f.appendf(r.fmt, r.args[0], r.args[1], r.args[2]);
+#pragma GCC diagnostic pop
+
+        r.seq.store(_tail + ISR_LOG_SLOTS - idx, std::memory_order_release);
+        ++_tail;
+        ++n;
+        out.writeln(f.data(), f.length());
+    }
+    return n;
+}
+
+uint32_t isrLogDropped() {
+    return _dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,37 @@
+#ifndef ISR_LOGGING_H
+#define ISR_LOGGING_H
+
+#include <LoggingBase.h>
+
+#ifndef ISR_LOG_SLOTS
+  // Records buffered between drains; must be a power of two.
+  #define ISR_LOG_SLOTS 32
+#endif
+
+/**
+ * Logging from interrupt handlers.
+ *
+ * logFromIsr() stores a fixed record (format pointer, three 32-bit
+ * arguments, micros() timestamp) in a lock-free ring and returns; it does
+ * not format, allocate, lock or touch a backend. The format string must be a
+ * literal (only its pointer is stored) and may use up to three 32-bit
+ * conversions such as %u, %d or %x.
+ *
+ * A normal task formats and forwards the records later:
+ *
+ *   void IRAM_ATTR onEdge() { logFromIsr("edge on pin %u", 4); }
+ *   void loop() { drainIsrLog(); ... }
+ *
+ * Records are dropped (and counted) while the ring is full.
+ */
+
+// ISR (and task) safe; returns false if the record was dropped.
+bool logFromIsr(const char* fmt, uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0);
+
+// Task context only, single consumer. Each record becomes one line
+// "[isr <timestamp> us] <message>". Returns the number of records written.
+size_t drainIsrLog(LoggingBase& out = *gLogger);
+
+uint32_t isrLogDropped();
+
+#endif
@@ -0,0 +1,73 @@
+#include <LineBufferedLogging.h>
+
+const void* LineBufferedLogging::currentTask() {
+#if defined(ESP32)
+    return xTaskGetCurrentTaskHandle();
+#else
+    static thread_local char marker;
+    return &marker;
+#endif
+}
+
+LineBufferedLogging::Slot* LineBufferedLogging::find(const void* task) {
+    for (Slot& s : slots_) {
+        if (s.owner.load(std::memory_order_acquire) == task) return &s;
+    }
+    return nullptr;
+}
+
+LineBufferedLogging::Slot* LineBufferedLogging::claim(const void* task) {
+    for (Slot& s : slots_) {
+        const void* expected = nullptr;
+        if (s.owner.load(std::memory_order_relaxed) == nullptr &&
+            s.owner.compare_exchange_strong(expected, task, std::memory_order_acquire)) {
+            s.len = 0;
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+void LineBufferedLogging::write(const char* data, size_t len) {
+    const void* task = currentTask();
+    Slot* slot = find(task);
+    if (!slot) slot = claim(task);
+    if (!slot) {
+        fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        inner_.write(data, len);
+        return;
+    }
+    while (len > 0) {
+        size_t n = sizeof(slot->data) - slot->len;
+        if (n > len) n = len;
+        memcpy(slot->data + slot->len, data, n);
+        slot->len += n;
+        data += n;
+        len -= n;
+        if (slot->len == sizeof(slot->data)) {
+            // Overlong line: emit what we have, keep collecting.
+            inner_.write(slot->data, slot->len);
+            slot->len = 0;
+        }
+    }
+}
+
+void LineBufferedLogging::complete(LogLevel level, const char* data, size_t len) {
+    const char* out = data;
+    size_t outLen = len;
+    Slot* slot = find(currentTask());
+    if (slot && slot->len + len <= sizeof(slot->data)) {
+        memcpy(slot->data + slot->len, data, len);
+        out = slot->data;
+        outLen = slot->len + len;
+    } else if (slot && slot->len > 0) {
+        // Too long for one buffer: emit the buffered start, then the rest
+        // completes the line (overlong lines are not atomic, see write()).
+        inner_.write(slot->data, slot->len);
+    }
+
+    if (level != LogLevel::None) inner_.log(level, out, outLen);
+    else                         inner_.writeln(out, outLen);
+
+    if (slot) slot->owner.store(nullptr, std::memory_order_release);
+}
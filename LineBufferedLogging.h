@@ -0,0 +1,62 @@
+#ifndef LINE_BUFFERED_LOGGING_H
+#define LINE_BUFFERED_LOGGING_H
+
+#include <LoggingBase.h>
+#include <atomic>
+
+#ifndef LOG_LINE_BUFFER_SLOTS
+  // Lines that can be under construction at the same time (one per task).
+  #define LOG_LINE_BUFFER_SLOTS 8
+#endif
+
+/**
+ * Whole-line atomic output for concurrent tasks, without a global mutex.
+ *
+ * Partial output (print/write) is collected in a line buffer owned by the
+ * calling task; the completed line is handed to the wrapped backend in a
+ * single writeln()/log() call. Complete lines (println/printf/LOG_xxx) skip
+ * the buffer entirely.
+ *
+ * Buffers come from a fixed pool and are claimed with a CAS on first partial
+ * write and returned when the line completes, so a task only holds one while
+ * it is building a line. If the pool is exhausted the output is passed
+ * through unbuffered and counted in fallbacks().
+ *
+ * The wrapped backend must emit each call in one piece: AsyncLogging (one
+ * ring slot per line) or SerialLogging (one UART write per line).
+ */
+class LineBufferedLogging : public LoggingBase {
+public:
+    explicit LineBufferedLogging(LoggingBase& inner) : inner_(inner) {}
+
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override;
+    void writeln(const char* data, size_t len) override { complete(LogLevel::None, data, len); }
+    void log(LogLevel level, const char* data, size_t len) override { complete(level, data, len); }
+    bool enabled(LogLevel level) const override { return inner_.enabled(level); }
+
+    // Partial writes that found no free buffer.
+    uint32_t fallbacks() const { return fallbacks_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<const void*> owner{nullptr};
+        size_t len = 0;
+        char data[LOGGING_LINE_BUFFER_SIZE];
+    };
+
+    static const void* currentTask();
+    Slot* find(const void* task);
+    Slot* claim(const void* task);
+    void complete(LogLevel level, const char* data, size_t len);
+
+    LoggingBase& inner_;
+    Slot slots_[LOG_LINE_BUFFER_SLOTS];
+    std::atomic<uint32_t> fallbacks_{0};
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include <LogLevel.h>
+#include <assert.h>
+
+// Runtime threshold for the LOG_xxx macros
+std::atomic<uint8_t> gLogLevel{LOG_LEVEL};
+void setLogLevel(LogLevel level) {
+    gLogLevel.store((uint8_t)level, std::memory_order_relaxed);
+}
+
+uint8_t gLogTagLevels[LOG_MAX_TAGS];
+
+// Constant-initialised, so tags constructed during static init see them.
+static LogTag* _tags[LOG_MAX_TAGS];
+static uint8_t _tagCount = 0;
+static uint8_t _tagOverflow = 0;   // tags that did not get a slot
+
+LogTag::LogTag(const char* name) : name_(name), index_(0) {
+    // Raise LOG_MAX_TAGS. Without asserts the tag shares slot 0 (and the
+    // level of the first tag), and logLevelCommand() reports the overflow.
+    assert(_tagCount < LOG_MAX_TAGS && "more LogTags than LOG_MAX_TAGS");
+    if (_tagCount >= LOG_MAX_TAGS) {
+        ++_tagOverflow;
+        return;
+    }
+    index_ = _tagCount++;
+    _tags[index_] = this;
+    gLogTagLevels[index_] = gLogLevel.load(std::memory_order_relaxed);
+}
+
+LogTag* findLogTag(const char* name) {
+    for (uint8_t i = 0; i < _tagCount; ++i) {
+        if (strcmp(_tags[i]->name(), name) == 0) return _tags[i];
+    }
+    return nullptr;
+}
+
+bool setLogLevel(const char* tag, LogLevel level) {
+    if (strcmp(tag, "*") == 0) {
+        for (uint8_t i = 0; i < _tagCount; ++i) gLogTagLevels[i] = (uint8_t)level;
+        return true;
+    }
+    LogTag* t = findLogTag(tag);
+    if (!t) return false;
+    t->setLevel(level);
+    return true;
+}
+
+static const char* const _levelNames[] = { "none", "error", "warn", "info", "debug", "trace" };
+
+const char* logLevelName(LogLevel level) {
+    uint8_t i = (uint8_t)level;
+    return i < sizeof(_levelNames) / sizeof(_levelNames[0]) ? _levelNames[i] : "?";
+}
+
+bool parseLogLevel(const char* text, LogLevel& level) {
+    const uint8_t count = sizeof(_levelNames) / sizeof(_levelNames[0]);
+    if (text[0] >= '0' && text[0] <= '9' && text[1] == '\0') {
+        if (text[0] - '0' >= count) return false;
+        level = (LogLevel)(text[0] - '0');
+        return true;
+    }
+    for (uint8_t i = 0; i < count; ++i) {
+        if (strcasecmp(text, _levelNames[i]) == 0 ||
+            (text[1] == '\0' && tolower((unsigned char)text[0]) == _levelNames[i][0])) {
+            level = (LogLevel)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool logLevelCommand(const char* command, LoggingBase& out) {
+    // Split into at most two words without touching the caller's buffer.
+    char words[2][24] = { "", "" };
+    int n = 0;
+    const char* p = command;
+    for (;;) {
+        while (*p == ' ' || *p == '\t') ++p;
+        if (!*p) break;
+        if (n == 2) return false;
+        size_t len = 0;
+        while (p[len] && p[len] != ' ' && p[len] != '\t') ++len;
+        if (len >= sizeof(words[0])) return false;
+        memcpy(words[n], p, len);
+        words[n][len] = '\0';
+        p += len;
+        ++n;
+    }
+
+    LogLevel level;
+    if (n == 0) {
+        out.logf(LogLevel::Info, "log level: %s", logLevelName(getLogLevel()));
+        for (uint8_t i = 0; i < _tagCount; ++i) {
+            out.logf(LogLevel::Info, "  %s: %s", _tags[i]->name(), logLevelName(_tags[i]->level()));
+        }
+        if (_tagOverflow) {
+            out.logf(LogLevel::Error, "%u tags share slot 0, raise LOG_MAX_TAGS", (unsigned)_tagOverflow);
+        }
+        return true;
+    }
+    if (n == 1) {
+        if (!parseLogLevel(words[0], level)) return false;
+        setLogLevel(level);
+        return true;
+    }
+    return parseLogLevel(words[1], level) && setLogLevel(words[0], level);
+}
@@ -0,0 +1,164 @@
+#ifndef LOG_LEVEL_H
+#define LOG_LEVEL_H
+
+#include <LoggingBase.h>
+
+/**
+ * Level-tagged logging macros.
+ *
+ *   LOG_ERROR("sensor %d timed out", id);
+ *   LOG_DEBUG("raw=%u", raw);
+ *
+ * LOG_LEVEL is the build-time minimum (e.g. -DLOG_LEVEL=LOG_LEVEL_DEBUG):
+ * macros above it expand to nothing, arguments included. The levels that are
+ * compiled in are checked against the runtime threshold gLogLevel (one load
+ * and one compare) before anything is formatted.
+ *
+ * Tagged variants use a per-module level instead of gLogLevel (LOG_LEVEL
+ * still bounds what is compiled in):
+ *
+ *   LOG_DEFINE_TAG(wifi);                  // once, at namespace scope
+ *   LOGT_DEBUG(wifi, "rssi=%d", rssi);     // prints "wifi: rssi=-61"
+ *   setLogLevel("wifi", LogLevel::Debug);  // or logLevelCommand("wifi debug")
+ *
+ * Lazy variants take a callable that fills a LogFormatter; it only runs if
+ * the level passes and the active backend consumes it (see
+ * LoggingBase::enabled()), so a disabled call costs a branch:
+ *
+ *   LOG_DEBUG_LAZY([&](LogFormatter& f) { f << "dump: " << sensor.dump(); });
+ */
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_TRACE 5
+
+#ifndef LOG_LEVEL
+  #define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_MAX_TAGS
+  // Size of the per-module level table. More tags than this trip an
+  // assert; with NDEBUG the extra ones share slot 0.
+  #define LOG_MAX_TAGS 16
+#endif
+
+// Runtime threshold, initialised to LOG_LEVEL. Atomic so tasks see
+// setLogLevel() without a data race; a relaxed load is a plain load.
+extern std::atomic<uint8_t> gLogLevel;
+
+void setLogLevel(LogLevel level);
+inline LogLevel getLogLevel() {
+    return (LogLevel)gLogLevel.load(std::memory_order_relaxed);
+}
+
+inline bool logLevelEnabled(LogLevel level) {
+    return (uint8_t)level <= gLogLevel.load(std::memory_order_relaxed);
+}
+
+// Per-module levels, indexed by LogTag::index().
+extern uint8_t gLogTagLevels[LOG_MAX_TAGS];
+
+// A named module. Tags get their table index when constructed, i.e. during
+// static initialisation for LOG_DEFINE_TAG, and start at the current
+// gLogLevel; enabled() is one array lookup.
+class LogTag {
+public:
+    explicit LogTag(const char* name);
+
+    const char* name() const { return name_; }
+    uint8_t index() const { return index_; }
+    bool enabled(LogLevel level) const {
+        return (uint8_t)level <= gLogTagLevels[index_];
+    }
+    void setLevel(LogLevel level) { gLogTagLevels[index_] = (uint8_t)level; }
+    LogLevel level() const { return (LogLevel)gLogTagLevels[index_]; }
+
+private:
+    const char* name_;
+    uint8_t index_;
+};
+
+#define LOG_DEFINE_TAG(tag) LogTag tag(#tag)
+#define LOG_DECLARE_TAG(tag) extern LogTag tag
+
+// Runtime control; "*" addresses all tags. Returns false for unknown tags.
+LogTag* findLogTag(const char* name);
+bool setLogLevel(const char* tag, LogLevel level);
+
+const char* logLevelName(LogLevel level);
+// Accepts names ("debug"), initials ("d") or digits ("4").
+bool parseLogLevel(const char* text, LogLevel& level);
+
+// Handles "<level>" (global threshold) and "<tag|*> <level>", e.g. from a
+// serial console. An empty command lists the tags and their levels.
+bool logLevelCommand(const char* command, LoggingBase& out = *gLogger);
+
+#define LOG_AT(level, fmt, ...) do {                              \
+        if (logLevelEnabled(level))                               \
+            gLogger->logf(level, fmt, ##__VA_ARGS__);             \
+    } while (0)
+
+#define LOG_LAZY(level, ...) do {                                 \
+        if (logLevelEnabled(level))                               \
+            gLogger->logLazy(level, __VA_ARGS__);                 \
+    } while (0)
+
+#define LOGT_AT(tag, level, fmt, ...) do {                                 \
+        if ((tag).enabled(level))                                           \
+            gLogger->logf(level, "%s: " fmt, (tag).name(), ##__VA_ARGS__);  \
+    } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+  #define LOG_ERROR(fmt, ...) LOG_AT(LogLevel::Error, fmt, ##__VA_ARGS__)
+  #define LOGT_ERROR(tag, fmt, ...) LOGT_AT(tag, LogLevel::Error, fmt, ##__VA_ARGS__)
+  #define LOG_ERROR_LAZY(...) LOG_LAZY(LogLevel::Error, __VA_ARGS__)
+#else
+  #define LOG_ERROR(fmt, ...) do {} while (0)
+  #define LOGT_ERROR(tag, fmt, ...) do {} while (0)
+  #define LOG_ERROR_LAZY(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+  #define LOG_WARN(fmt, ...) LOG_AT(LogLevel::Warn, fmt, ##__VA_ARGS__)
+  #define LOGT_WARN(tag, fmt, ...) LOGT_AT(tag, LogLevel::Warn, fmt, ##__VA_ARGS__)
+  #define LOG_WARN_LAZY(...) LOG_LAZY(LogLevel::Warn, __VA_ARGS__)
+#else
+  #define LOG_WARN(fmt, ...) do {} while (0)
+  #define LOGT_WARN(tag, fmt, ...) do {} while (0)
+  #define LOG_WARN_LAZY(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+  #define LOG_INFO(fmt, ...) LOG_AT(LogLevel::Info, fmt, ##__VA_ARGS__)
+  #define LOGT_INFO(tag, fmt, ...) LOGT_AT(tag, LogLevel::Info, fmt, ##__VA_ARGS__)
+  #define LOG_INFO_LAZY(...) LOG_LAZY(LogLevel::Info, __VA_ARGS__)
+#else
+  #define LOG_INFO(fmt, ...) do {} while (0)
+  #define LOGT_INFO(tag, fmt, ...) do {} while (0)
+  #define LOG_INFO_LAZY(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+  #define LOG_DEBUG(fmt, ...) LOG_AT(LogLevel::Debug, fmt, ##__VA_ARGS__)
+  #define LOGT_DEBUG(tag, fmt, ...) LOGT_AT(tag, LogLevel::Debug, fmt, ##__VA_ARGS__)
+  #define LOG_DEBUG_LAZY(...) LOG_LAZY(LogLevel::Debug, __VA_ARGS__)
+#else
+  #define LOG_DEBUG(fmt, ...) do {} while (0)
+  #define LOGT_DEBUG(tag, fmt, ...) do {} while (0)
+  #define LOG_DEBUG_LAZY(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+  #define LOG_TRACE(fmt, ...) LOG_AT(LogLevel::Trace, fmt, ##__VA_ARGS__)
+  #define LOGT_TRACE(tag, fmt, ...) LOGT_AT(tag, LogLevel::Trace, fmt, ##__VA_ARGS__)
+  #define LOG_TRACE_LAZY(...) LOG_LAZY(LogLevel::Trace, __VA_ARGS__)
+#else
+  #define LOG_TRACE(fmt, ...) do {} while (0)
+  #define LOGT_TRACE(tag, fmt, ...) do {} while (0)
+  #define LOG_TRACE_LAZY(...) do {} while (0)
+#endif
+
+#endif
@@ -1,11 +1,362 @@
 #include <LoggingBase.h>
+#include <StructuredLogging.h>
+#include <atomic>
 
 // One instance of each backend
 static SerialLogging  _serialLogger;
 static NullLogging    _nullLogger;
 
 // Default logger is Serial
-LoggingBase* gLogger = &_serialLogger;
-void setLogger(LoggingBase* logger) {
-    gLogger = logger ? logger : &_nullLogger;
+LoggerHandle gLogger(&_serialLogger);
+LoggingBase* setLogger(LoggingBase* logger) {
+    return gLogger.exchange(logger ? logger : &_nullLogger);
+}
+
+// ---- logger grace periods ---------------------------------------------------
+
+// Each registered reader publishes the last epoch it saw while quiescent;
+// 0 means offline. A grace period ends once every online reader has caught
+// up with the epoch started by synchronizeLogger().
+static std::atomic<uint32_t> _loggerEpoch{1};
+static std::atomic<uint32_t> _readerEpochs[LOGGER_MAX_READERS];
+static std::atomic<bool> _readerUsed[LOGGER_MAX_READERS];
+// Live LoggerReaders that found no free slot.
+static std::atomic<uint32_t> _untrackedReaders{0};
+
+LoggerReader::LoggerReader() : slot_(-1) {
+    for (int i = 0; i < LOGGER_MAX_READERS; ++i) {
+        bool expected = false;
+        if (_readerUsed[i].compare_exchange_strong(expected, true)) {
+            slot_ = i;
+            quiescent();
+            return;
+        }
+    }
+    _untrackedReaders.fetch_add(1, std::memory_order_seq_cst);
+}
+
+LoggerReader::~LoggerReader() {
+    if (slot_ < 0) {
+        _untrackedReaders.fetch_sub(1, std::memory_order_seq_cst);
+        return;
+    }
+    offline();
+    _readerUsed[slot_].store(false, std::memory_order_release);
+}
+
+void LoggerReader::quiescent() {
+    if (slot_ < 0) return;
+    _readerEpochs[slot_].store(_loggerEpoch.load(std::memory_order_seq_cst),
+                               std::memory_order_seq_cst);
+}
+
+void LoggerReader::offline() {
+    if (slot_ < 0) return;
+    _readerEpochs[slot_].store(0, std::memory_order_seq_cst);
+}
+
+bool synchronizeLogger(LoggerReader* caller) {
+    if (_untrackedReaders.load(std::memory_order_seq_cst) != 0) return false;
+    uint32_t target = _loggerEpoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    if (caller) caller->quiescent();
+    for (int i = 0; i < LOGGER_MAX_READERS; ++i) {
+        for (;;) {
+            uint32_t e = _readerEpochs[i].load(std::memory_order_seq_cst);
+            if (e == 0 || (int32_t)(e - target) >= 0 ||
+                !_readerUsed[i].load(std::memory_order_acquire)) break;
+            delay(1);
+        }
+    }
+    return true;
+}
+
+// ---- SerialLogging ----------------------------------------------------------
+
+void SerialLogging::writeln(const char* data, size_t len) {
+    // One UART write per line so lines from different tasks do not interleave.
+    char buf[LOGGING_LINE_BUFFER_SIZE + 2];
+    if (len <= LOGGING_LINE_BUFFER_SIZE) {
+        memcpy(buf, data, len);
+        buf[len] = '\r';
+        buf[len + 1] = '\n';
+        Serial.write(buf, len + 2);
+        return;
+    }
+    Serial.write(data, len);
+    Serial.println();
+}
+
+// ---- LoggingBase ------------------------------------------------------------
+
+static std::atomic<uint32_t> _adapterAllocations{0};
+
+uint32_t LoggingBase::adapterAllocations() {
+    return _adapterAllocations.load(std::memory_order_relaxed);
+}
+
+void LoggingBase::countAdapterAllocation() {
+    _adapterAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LoggingBase::write(const char* data, size_t len) {
+    countAdapterAllocation();
+    String s;
+    s.reserve(len);
+    s.concat(data, len);
+    print(s);
+}
+
+void LoggingBase::writeln(const char* data, size_t len) {
+    countAdapterAllocation();
+    String s;
+    s.reserve(len);
+    s.concat(data, len);
+    println(s);
+}
+
+void LoggingBase::writeFlash(const __FlashStringHelper* msg, bool newline) {
+    // Copy out of flash in line-buffer sized chunks.
+    const char* p = reinterpret_cast<const char*>(msg);
+    size_t left = p ? strlen_P(p) : 0;
+    char buf[LOGGING_LINE_BUFFER_SIZE];
+    do {
+        size_t n = left < sizeof(buf) ? left : sizeof(buf);
+        memcpy_P(buf, p, n);
+        p += n;
+        left -= n;
+        if (left == 0 && newline) writeln(buf, n);
+        else                      write(buf, n);
+    } while (left > 0);
+}
+
+void LoggingBase::vprintf(bool newline, const char* fmt, va_list args) {
+    char buf[LOGGING_LINE_BUFFER_SIZE];
+    LogFormatter f(buf, sizeof(buf));
+    f.vappendf(fmt, args);
+    if (newline) writeln(f.data(), f.length());
+    else         write(f.data(), f.length());
+}
+
+void LoggingBase::printf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vprintf(false, fmt, args);
+    va_end(args);
+}
+
+void LoggingBase::printfln(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vprintf(true, fmt, args);
+    va_end(args);
+}
+
+void LoggingBase::vlogf(LogLevel level, const char* fmt, va_list args) {
+    char buf[LOGGING_LINE_BUFFER_SIZE];
+    LogFormatter f(buf, sizeof(buf));
+    f.vappendf(fmt, args);
+    log(level, f.data(), f.length());
+}
+
+void LoggingBase::logf(LogLevel level, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vlogf(level, fmt, args);
+    va_end(args);
+}
+
+void LoggingBase::logRecord(LogLevel level, const uint8_t* cbor, size_t len) {
+    char buf[LOGGING_LINE_BUFFER_SIZE];
+    LogFormatter f(buf, sizeof(buf));
+    if (!renderLogRecord(cbor, len, f)) return;
+    log(level, f.data(), f.length());
+}
+
+void LoggingBase::hexdump(const void* data, size_t len, uint8_t flags) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    char buf[LOGGING_LINE_BUFFER_SIZE];
+    LogFormatter f(buf, sizeof(buf));
+
+    if (flags == LogHexPlain) {
+        // As many bytes per line as the buffer holds.
+        const size_t perLine = (sizeof(buf) - 1) / 2;
+        do {
+            size_t n = len < perLine ? len : perLine;
+            f.clear();
+            f.appendHex(p, n);
+            writeln(f.data(), f.length());
+            p += n;
+            len -= n;
+        } while (len > 0);
+        return;
+    }
+
+    static const char kDigits[] = "0123456789abcdef";
+    for (size_t offset = 0; offset < len || offset == 0; offset += 16) {
+        size_t n = len - offset < 16 ? len - offset : 16;
+        f.clear();
+        if (flags & LogHexOffset) {
+            char off[10];
+            for (int i = 0; i < 8; ++i) off[i] = kDigits[(offset >> (28 - 4 * i)) & 0xf];
+            off[8] = off[9] = ' ';
+            f.append(off, sizeof(off));
+        }
+        f.appendHex(p + offset, n, ' ');
+        if (flags & LogHexAscii) {
+            // Pad short last lines so the text column lines up.
+            char col[3 * 16 + 2 + 16 + 1];
+            size_t c = 0;
+            for (size_t i = n; i < 16; ++i) { col[c++] = ' '; col[c++] = ' '; col[c++] = ' '; }
+            col[c++] = ' ';
+            col[c++] = '|';
+            for (size_t i = 0; i < n; ++i) {
+                uint8_t b = p[offset + i];
+                col[c++] = (b >= 0x20 && b < 0x7f) ? (char)b : '.';
+            }
+            col[c++] = '|';
+            f.append(col, c);
+        }
+        writeln(f.data(), f.length());
+        if (len == 0) break;
+    }
+}
+
+// ---- LogFormatter -----------------------------------------------------------
+
+static const char kHexPairs[] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+LogFormatter::LogFormatter(char* buf, size_t capacity) : buf_(buf), cap_(capacity) {
+    buf_[0] = '\0';
+}
+
+LogFormatter& LogFormatter::append(const char* s, size_t n) {
+    size_t room = remaining();
+    if (n > room) {
+        n = room;
+        truncated_ = true;
+    }
+    memcpy(buf_ + len_, s, n);
+    len_ += n;
+    buf_[len_] = '\0';
+    return *this;
+}
+
+LogFormatter& LogFormatter::append(const char* s) {
+    return s ? append(s, strlen(s)) : *this;
+}
+
+LogFormatter& LogFormatter::append(const __FlashStringHelper* s) {
+    const char* p = reinterpret_cast<const char*>(s);
+    if (!p) return *this;
+    size_t n = strlen_P(p);
+    size_t room = remaining();
+    if (n > room) {
+        n = room;
+        truncated_ = true;
+    }
+    memcpy_P(buf_ + len_, p, n);
+    len_ += n;
+    buf_[len_] = '\0';
+    return *this;
+}
+
+LogFormatter& LogFormatter::append(char c) {
+    return append(&c, 1);
+}
+
+LogFormatter& LogFormatter::append(unsigned long long v) {
+    char digits[20];
+    size_t n = 0;
+    do {
+        digits[sizeof(digits) - 1 - n++] = char('0' + v % 10);
+        v /= 10;
+    } while (v);
+    return append(digits + sizeof(digits) - n, n);
+}
+
+LogFormatter& LogFormatter::append(long long v) {
+    if (v < 0) {
+        append('-');
+        return append((unsigned long long)0 - (unsigned long long)v);
+    }
+    return append((unsigned long long)v);
+}
+
+LogFormatter& LogFormatter::append(double v, uint8_t decimals) {
+    // Same output as Arduino's String(double): fixed decimals, "nan"/"inf"/"ovf".
+    if (v != v) return append("nan");
+    if (v < 0) {
+        append('-');
+        v = -v;
+    }
+    if (v > 4294967040.0) return append(v == v * 2 ? "inf" : "ovf");
+
+    double rounding = 0.5;
+    for (uint8_t i = 0; i < decimals; ++i) rounding /= 10.0;
+    v += rounding;
+
+    unsigned long whole = (unsigned long)v;
+    double frac = v - (double)whole;
+    append(whole);
+    if (decimals > 0) append('.');
+    for (uint8_t i = 0; i < decimals; ++i) {
+        frac *= 10.0;
+        unsigned digit = (unsigned)frac;
+        append(char('0' + digit));
+        frac -= digit;
+    }
+    return *this;
+}
+
+LogFormatter& LogFormatter::appendHex(const void* data, size_t len, char separator) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    size_t width = separator ? 3 : 2;
+    size_t room = remaining();
+    // Room for n bytes: 2n digits plus n-1 separators.
+    size_t fit = separator ? (room + 1) / 3 : room / 2;
+    if (len > fit) {
+        len = fit;
+        truncated_ = true;
+    }
+    char* out = buf_ + len_;
+    for (size_t i = 0; i < len; ++i) {
+        memcpy(out, kHexPairs + 2 * p[i], 2);
+        out[2] = separator;
+        out += width;
+    }
+    if (len > 0 && separator) --out;
+    len_ = out - buf_;
+    buf_[len_] = '\0';
+    return *this;
+}
+
+LogFormatter& LogFormatter::vappendf(const char* fmt, va_list args) {
+    size_t room = remaining();
+    int n = vsnprintf(buf_ + len_, room + 1, fmt, args);
+    if (n < 0) {
+        buf_[len_] = '\0';
+        return *this;
+    }
+    if ((size_t)n > room) {
+        n = (int)room;
+        truncated_ = true;
+    }
+    len_ += (size_t)n;
+    return *this;
+}
+
+LogFormatter& LogFormatter::appendf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vappendf(fmt, args);
+    va_end(args);
+    return *this;
 }
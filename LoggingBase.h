@@ -2,6 +2,74 @@
 #define LOGGING_BASE_H
 
 #include <Arduino.h>
+#include <stdarg.h>
+#include <atomic>
+
+#ifndef LOGGER_MAX_READERS
+  // Tasks that can register as LoggerReader (see synchronizeLogger()).
+  #define LOGGER_MAX_READERS 8
+#endif
+#ifndef LOGGING_LINE_BUFFER_SIZE
+  // Stack buffer used by printf/LogLine and the value overloads (incl. NUL).
+  #define LOGGING_LINE_BUFFER_SIZE 192
+#endif
+
+// Message severity; a lower value is more severe. See LogLevel.h for the
+// level-tagged macros and the build-time/runtime thresholds.
+enum class LogLevel : uint8_t {
+    None  = 0,
+    Error = 1,
+    Warn  = 2,
+    Info  = 3,
+    Debug = 4,
+    Trace = 5,
+};
+
+// Column options for hex dumps; without any, bytes are packed densely.
+enum LogHexFlags : uint8_t {
+    LogHexPlain  = 0,
+    LogHexOffset = 1 << 0,   // "00000010  " offset column, 16 bytes per line
+    LogHexAscii  = 1 << 1,   // "|text....|" column, 16 bytes per line
+};
+
+// Appends text and numbers to a caller-owned buffer without allocating.
+// Output that does not fit is cut off; the buffer stays NUL-terminated.
+class LogFormatter {
+public:
+    LogFormatter(char* buf, size_t capacity);
+
+    LogFormatter& append(const char* s);
+    LogFormatter& append(const char* s, size_t n);
+    LogFormatter& append(const String& s) { return append(s.c_str(), s.length()); }
+    LogFormatter& append(const __FlashStringHelper* s);
+    LogFormatter& append(char c);
+    LogFormatter& append(int v)                { return append((long long)v); }
+    LogFormatter& append(unsigned int v)       { return append((unsigned long long)v); }
+    LogFormatter& append(long v)               { return append((long long)v); }
+    LogFormatter& append(unsigned long v)      { return append((unsigned long long)v); }
+    LogFormatter& append(long long v);
+    LogFormatter& append(unsigned long long v);
+    LogFormatter& append(double v, uint8_t decimals = 2);
+    // Lowercase hex, two digits per byte, optional separator between bytes.
+    LogFormatter& appendHex(const void* data, size_t len, char separator = '\0');
+    LogFormatter& appendf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    LogFormatter& vappendf(const char* fmt, va_list args);
+
+    template <typename T>
+    LogFormatter& operator<<(const T& value) { return append(value); }
+
+    const char* data() const { return buf_; }
+    size_t length() const { return len_; }
+    size_t remaining() const { return cap_ - 1 - len_; }
+    bool truncated() const { return truncated_; }
+    void clear() { len_ = 0; buf_[0] = '\0'; truncated_ = false; }
+
+private:
+    char* buf_;
+    size_t cap_;
+    size_t len_ = 0;
+    bool truncated_ = false;
+};
 
 class LoggingBase {
 public:
@@ -11,45 +79,220 @@ public:
     virtual void print(const String& msg) = 0;
     virtual void println(const String& msg) = 0;
 
-    virtual void print(const char* msg) { print(String(msg)); }
-    virtual void println(const char* msg) { println(String(msg)); }
+    // Zero-allocation interface: data need not be NUL-terminated.
+    // The defaults adapt to the String interface above (and allocate);
+    // backends override these to avoid that.
+    virtual void write(const char* data, size_t len);
+    virtual void writeln(const char* data, size_t len);
+
+    virtual void print(const char* msg) { write(msg, msg ? strlen(msg) : 0); }
+    virtual void println(const char* msg) { writeln(msg, msg ? strlen(msg) : 0); }
+
+    virtual void print(const __FlashStringHelper* msg) { writeFlash(msg, false); }
+    virtual void println(const __FlashStringHelper* msg) { writeFlash(msg, true); }
+
+    // printf-style output formatted into a stack buffer
+    void printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    void printfln(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    void vprintf(bool newline, const char* fmt, va_list args);
+
+    // Hex dump of a binary payload, formatted straight into the line buffer.
+    void hexdump(const void* data, size_t len, uint8_t flags = LogHexPlain);
+
+    // Level-tagged line; backends that filter or route by severity override
+    // this, the default ignores the level.
+    virtual void log(LogLevel level, const char* data, size_t len) { writeln(data, len); }
+    void logf(LogLevel level, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+    void vlogf(LogLevel level, const char* fmt, va_list args);
 
-    virtual void print(const __FlashStringHelper* msg) { print(String(msg)); }
-    virtual void println(const __FlashStringHelper* msg) { println(String(msg)); }
+    // Structured record (CBOR, see StructuredLogging.h). The default renders
+    // it as a text line and passes that to log().
+    virtual void logRecord(LogLevel level, const uint8_t* cbor, size_t len);
 
-    // Templated helpers for any printable type
+    // Whether a line at `level` would be consumed at all; wrappers forward
+    // this to what they wrap.
+    virtual bool enabled(LogLevel level) const { return true; }
+
+    // Deferred formatting: `fill(LogFormatter&)` only runs if enabled(level).
+    //   gLogger->logLazy(LogLevel::Debug, [&](LogFormatter& f) { f << dump(); });
+    template <typename F>
+    void logLazy(LogLevel level, F&& fill) {
+        if (!enabled(level)) return;
+        char buf[LOGGING_LINE_BUFFER_SIZE];
+        LogFormatter f(buf, sizeof(buf));
+        fill(f);
+        log(level, f.data(), f.length());
+    }
+
+    // Templated helpers for any printable type (numbers, char, String, ...)
     template <typename T>
     void print(const T& value) {
-        print(String(value));
+        char buf[LOGGING_LINE_BUFFER_SIZE];
+        LogFormatter f(buf, sizeof(buf));
+        f.append(value);
+        write(f.data(), f.length());
     }
     template <typename T>
     void println(const T& value) {
-        println(String(value));
+        char buf[LOGGING_LINE_BUFFER_SIZE];
+        LogFormatter f(buf, sizeof(buf));
+        f.append(value);
+        writeln(f.data(), f.length());
+    }
+
+    // Number of times a write()/writeln() call fell back to the String
+    // adapters above (each builds one String temporary). This counts only
+    // that fallback, not heap use in general: it shows whether a backend
+    // still routes through String, and stays constant once all of them
+    // override write(). Use an allocator hook to measure real allocations.
+    static uint32_t adapterAllocations();
+
+protected:
+    static void countAdapterAllocation();
+
+private:
+    void writeFlash(const __FlashStringHelper* msg, bool newline);
+};
+
+// Streams into a stack buffer and emits a single line when it goes out of
+// scope, e.g.  LogLine(*gLogger) << "t=" << t << " ms";
+class LogLine {
+public:
+    explicit LogLine(LoggingBase& out) : out_(out), fmt_(buf_, sizeof(buf_)) {}
+    ~LogLine() { out_.writeln(fmt_.data(), fmt_.length()); }
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    template <typename T>
+    LogLine& operator<<(const T& value) {
+        fmt_.append(value);
+        return *this;
     }
+    LogFormatter& formatter() { return fmt_; }
+
+private:
+    LoggingBase& out_;
+    char buf_[LOGGING_LINE_BUFFER_SIZE];
+    LogFormatter fmt_;
 };
 
 
 class SerialLogging : public LoggingBase {
 public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+
     void print(const String& msg) override {
-        Serial.print(msg);
+        write(msg.c_str(), msg.length());
     }
     void println(const String& msg) override {
-        Serial.println(msg);
+        writeln(msg.c_str(), msg.length());
+    }
+    void write(const char* data, size_t len) override {
+        Serial.write(data, len);
     }
+    void writeln(const char* data, size_t len) override;
 };
 
 class NullLogging : public LoggingBase {
 public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+
     void print(const String& msg) override {
         // No operation
     }
     void println(const String& msg) override {
         // No operation
     }
+    void write(const char* data, size_t len) override {}
+    void writeln(const char* data, size_t len) override {}
+    bool enabled(LogLevel level) const override { return false; }
+};
+
+// The current logger. Each use (gLogger->..., *gLogger) is a single acquire
+// load of an atomic pointer, so setLogger() may run concurrently.
+class LoggerHandle {
+public:
+    constexpr LoggerHandle(LoggingBase* logger) : ptr_(logger) {}
+    LoggerHandle(const LoggerHandle&) = delete;
+    LoggerHandle& operator=(const LoggerHandle&) = delete;
+
+    LoggingBase* get() const { return ptr_.load(std::memory_order_acquire); }
+    LoggingBase* operator->() const { return get(); }
+    LoggingBase& operator*() const { return *get(); }
+    operator LoggingBase*() const { return get(); }
+
+    LoggingBase* exchange(LoggingBase* logger) {
+        return ptr_.exchange(logger, std::memory_order_acq_rel);
+    }
+
+private:
+    std::atomic<LoggingBase*> ptr_;
 };
 
-extern LoggingBase* gLogger;
+extern LoggerHandle gLogger;
+
+// Installs `logger` (nullptr selects a no-op backend) and returns the
+// previous one, which calls already in flight may still be using.
+LoggingBase* setLogger(LoggingBase* logger);
+
+/**
+ * Quiescent-state tracking for tasks that log, so a replaced backend can be
+ * torn down safely without any lock on the logging path.
+ *
+ * Contract: every task that may call through gLogger while a backend is
+ * replaced must own a LoggerReader, including the Arduino loop() task.
+ * synchronizeLogger() cannot see calls from unregistered tasks; if such a
+ * task may exist, keep the old backend alive (static backends never need to
+ * be freed).
+ *
+ * A task registers once and reports a quiescent state wherever it holds no
+ * logger reference, typically once per loop iteration:
+ *
+ *   void worker(void*) {
+ *     LoggerReader reader;
+ *     for (;;) {
+ *       ... gLogger->println("tick"); ...
+ *       reader.quiescent();
+ *     }
+ *   }
+ *
+ *   void loop() {
+ *     static LoggerReader reader;
+ *     ... gLogger->println("loop"); ...
+ *     reader.quiescent();
+ *   }
+ *
+ *   LoggingBase* old = setLogger(&fileLog);
+ *   if (synchronizeLogger()) delete old;   // every task has left `old`
+ *
+ * A task that blocks for long should go offline() first so it does not
+ * stall synchronizeLogger().
+ */
+class LoggerReader {
+public:
+    LoggerReader();
+    ~LoggerReader();
+    LoggerReader(const LoggerReader&) = delete;
+    LoggerReader& operator=(const LoggerReader&) = delete;
+
+    // False if all LOGGER_MAX_READERS slots were taken.
+    bool registered() const { return slot_ >= 0; }
+
+    // Declares that this task holds no reference to a previous logger.
+    void quiescent();
+    // Excludes this task from grace periods until online().
+    void offline();
+    void online() { quiescent(); }
+
+private:
+    int slot_;
+};
 
-void setLogger(LoggingBase* logger);
-#endif
\ No newline at end of file
+// Waits until every registered, online reader other than `caller` has
+// passed a quiescent state since the last setLogger(). Returns false without
+// waiting if a LoggerReader failed to register (all LOGGER_MAX_READERS
+// slots taken): that task is not tracked, so the old logger must be kept.
+bool synchronizeLogger(LoggerReader* caller = nullptr);
+#endif
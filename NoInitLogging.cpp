@@ -0,0 +1,159 @@
+#include <NoInitLogging.h>
+
+#if defined(ESP32)
+#include <esp_attr.h>
+#include <esp_system.h>
+#define NOINIT_LOG_ATTR RTC_NOINIT_ATTR
+static portMUX_TYPE _noInitMux = portMUX_INITIALIZER_UNLOCKED;
+#define NOINIT_LOCK()   portENTER_CRITICAL(&_noInitMux)
+#define NOINIT_UNLOCK() portEXIT_CRITICAL(&_noInitMux)
+#else
+#define NOINIT_LOG_ATTR
+#define NOINIT_LOCK()   do {} while (0)
+#define NOINIT_UNLOCK() do {} while (0)
+#endif
+
+namespace {
+
+struct NoInitRing {
+    uint32_t magic;
+    uint32_t head;    // next write position
+    uint32_t used;    // valid bytes, up to NOINIT_LOG_SIZE
+    uint32_t sum;     // sum of all data bytes
+    uint32_t check;   // covers the fields above
+    char data[NOINIT_LOG_SIZE];
+};
+
+const uint32_t kNoInitMagic = 0x4e494c47; // "NILG"
+
+NOINIT_LOG_ATTR NoInitRing _ring;
+
+uint32_t headerCheck(const NoInitRing& r) {
+    return (r.magic ^ (r.head * 2654435761u) ^ (r.used * 40503u) ^ r.sum) + 0x9e3779b9u;
+}
+
+void resetRing() {
+    memset(_ring.data, 0, sizeof(_ring.data));
+    _ring.magic = kNoInitMagic;
+    _ring.head = 0;
+    _ring.used = 0;
+    _ring.sum = 0;
+    _ring.check = headerCheck(_ring);
+}
+
+#if defined(ESP32)
+const char* resetReasonName(esp_reset_reason_t r) {
+    switch (r) {
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "interrupt watchdog";
+        case ESP_RST_TASK_WDT:  return "task watchdog";
+        case ESP_RST_WDT:       return "watchdog";
+        case ESP_RST_SW:        return "software reset";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        case ESP_RST_DEEPSLEEP: return "deep sleep";
+        default:                return "reset";
+    }
+}
+#endif
+
+} // namespace
+
+bool NoInitLogging::begin() {
+    NOINIT_LOCK();
+    bool valid = _ring.magic == kNoInitMagic && _ring.head < NOINIT_LOG_SIZE &&
+                 _ring.used <= NOINIT_LOG_SIZE && _ring.check == headerCheck(_ring);
+    if (valid) {
+        uint32_t sum = 0;
+        for (size_t i = 0; i < NOINIT_LOG_SIZE; ++i) sum += (uint8_t)_ring.data[i];
+        valid = sum == _ring.sum;
+    }
+    if (!valid) resetRing();
+    bool have = _ring.used > 0;
+    // The previous run's output stays frozen until replay() has emitted it.
+    frozen_.store(have, std::memory_order_release);
+    ready_ = true;
+    NOINIT_UNLOCK();
+    return have;
+}
+
+size_t NoInitLogging::replay(LoggingBase& out) {
+    if (!ready_) begin();
+    if (!frozen_.load(std::memory_order_acquire)) return 0;
+    // Nothing appends to the ring while it is frozen, so it can be read
+    // without the lock, even when `out` is or wraps this logger.
+    size_t used = _ring.used;
+
+#if defined(ESP32)
+    out.printfln("--- log before %s ---", resetReasonName(esp_reset_reason()));
+#else
+    out.println("--- log before reset ---");
+#endif
+    // Oldest byte is at head once the ring has wrapped; after a wrap the
+    // first line is usually cut, so skip up to its end.
+    size_t pos = used < NOINIT_LOG_SIZE ? 0 : _ring.head;
+    size_t left = used;
+    if (used == NOINIT_LOG_SIZE) {
+        while (left > 0 && _ring.data[pos] != '\n') {
+            pos = (pos + 1) % NOINIT_LOG_SIZE;
+            --left;
+        }
+        if (left > 0) {
+            pos = (pos + 1) % NOINIT_LOG_SIZE;
+            --left;
+        }
+    }
+    char line[LOGGING_LINE_BUFFER_SIZE];
+    size_t n = 0;
+    for (; left > 0; --left) {
+        char c = _ring.data[pos];
+        pos = (pos + 1) % NOINIT_LOG_SIZE;
+        if (c == '\n' || n == sizeof(line)) {
+            out.writeln(line, n);
+            n = 0;
+            if (c == '\n') continue;
+        }
+        line[n++] = c;
+    }
+    if (n > 0) out.writeln(line, n);
+    out.println("--- end of previous log ---");
+
+    NOINIT_LOCK();
+    resetRing();
+    frozen_.store(false, std::memory_order_release);
+    NOINIT_UNLOCK();
+    return used;
+}
+
+void NoInitLogging::append(const char* data, size_t len, bool newline) {
+    if (!ready_ || frozen_.load(std::memory_order_acquire)) return;
+    NOINIT_LOCK();
+    uint32_t head = _ring.head;
+    uint32_t sum = _ring.sum;
+    size_t total = len + (newline ? 1 : 0);
+    for (size_t i = 0; i < total; ++i) {
+        char c = i < len ? data[i] : '\n';
+        sum += (uint8_t)c - (uint8_t)_ring.data[head];
+        _ring.data[head] = c;
+        if (++head == NOINIT_LOG_SIZE) head = 0;
+    }
+    _ring.head = head;
+    _ring.sum = sum;
+    _ring.used = _ring.used + total > NOINIT_LOG_SIZE ? NOINIT_LOG_SIZE : _ring.used + total;
+    _ring.check = headerCheck(_ring);
+    NOINIT_UNLOCK();
+}
+
+void NoInitLogging::write(const char* data, size_t len) {
+    append(data, len, false);
+    inner_.write(data, len);
+}
+
+void NoInitLogging::writeln(const char* data, size_t len) {
+    append(data, len, true);
+    inner_.writeln(data, len);
+}
+
+void NoInitLogging::log(LogLevel level, const char* data, size_t len) {
+    append(data, len, true);
+    inner_.log(level, data, len);
+}
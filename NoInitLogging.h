@@ -0,0 +1,64 @@
+#ifndef NOINIT_LOGGING_H
+#define NOINIT_LOGGING_H
+
+#include <LoggingBase.h>
+#include <atomic>
+
+#ifndef NOINIT_LOG_SIZE
+  // Bytes of recent output kept; on the ESP32 this lives in RTC slow memory
+  // (8 KB in total), so keep it small.
+  #define NOINIT_LOG_SIZE 2048
+#endif
+
+/**
+ * Crash-surviving log tail.
+ *
+ * Forwards everything to the wrapped backend and mirrors it into a ring in
+ * RAM that is not cleared on reset (RTC_NOINIT_ATTR on the ESP32; a plain
+ * static buffer stands in on a host build). After a panic or watchdog reset
+ * the last NOINIT_LOG_SIZE bytes can be replayed on the next boot:
+ *
+ *   static SerialLogging serialSink;
+ *   static NoInitLogging crashLog(serialSink);
+ *   void setup() {
+ *     crashLog.begin();          // validates the ring left by the last run
+ *     setLogger(&crashLog);
+ *     crashLog.replay();         // prints it through gLogger, then clears it
+ *   }
+ *
+ * The header carries a check word and an additive checksum over the data
+ * that is updated incrementally per appended byte, so appends stay a copy
+ * loop and the whole ring is verified at boot.
+ */
+class NoInitLogging : public LoggingBase {
+public:
+    explicit NoInitLogging(LoggingBase& inner) : inner_(inner) {}
+
+    // Validates the ring; an invalid ring (power-on, corruption) is reset.
+    // Returns true if content from the previous run is available; new output
+    // is then only forwarded, not kept, until replay() has run.
+    bool begin();
+
+    // Writes the previous run's output, oldest line first, then clears it
+    // and starts keeping new output. Returns the number of bytes replayed.
+    size_t replay(LoggingBase& out = *gLogger);
+
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override;
+    void writeln(const char* data, size_t len) override;
+    void log(LogLevel level, const char* data, size_t len) override;
+    bool enabled(LogLevel level) const override { return true; }
+
+private:
+    void append(const char* data, size_t len, bool newline);
+
+    LoggingBase& inner_;
+    bool ready_ = false;
+    std::atomic<bool> frozen_{false};   // previous run not replayed yet
+};
+
+#endif
@@ -0,0 +1,255 @@
+#include <NtpTimeProvider.h>
+
+// Needs lwIP sockets (ESP32) or POSIX ones (host build); the ESP8266 core
+// has neither, so the provider is left out there.
+#if defined(ESP32) || !defined(ARDUINO)
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+
+#if defined(ESP32)
+#include <lwip/sockets.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+// NTP era 0 starts 1900-01-01, 70 years before the unix epoch.
+static const uint64_t kNtpToUnixSeconds = 2208988800ull;
+static const size_t kPacketSize = 48;
+// Offsets within this many jitters count as "in control" for the poll.
+static const float kPollGate = 4.0f;
+static const int16_t kPollLimit = 30;
+static const float kJitterFloorUs = 1000.0f;
+
+static uint64_t toNtp(int64_t unixUs) {
+    uint64_t s = (uint64_t)(unixUs / 1000000) + kNtpToUnixSeconds;
+    uint64_t frac = ((uint64_t)(unixUs % 1000000) << 32) / 1000000;
+    return (s << 32) | frac;
+}
+
+static int64_t fromNtp(uint64_t ntp) {
+    int64_t s = (int64_t)(ntp >> 32) - (int64_t)kNtpToUnixSeconds;
+    int64_t us = (int64_t)(((ntp & 0xffffffffull) * 1000000) >> 32);
+    return s * 1000000 + us;
+}
+
+static uint64_t readNtp(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+static void writeNtp(uint8_t* p, uint64_t v) {
+    for (int i = 7; i >= 0; --i) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+NtpTimeProvider::NtpTimeProvider(const char* serverIp, uint16_t port, int32_t utcOffsetSeconds)
+    : serverIp_(serverIp), port_(port), utcOffset_(utcOffsetSeconds) {}
+
+NtpTimeProvider::~NtpTimeProvider() {
+    end();
+}
+
+void NtpTimeProvider::begin() {
+    if (socket_ >= 0) return;
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0) return;
+    // update() must never block on the network stack.
+    fcntl(socket_, F_SETFL, fcntl(socket_, F_GETFL, 0) | O_NONBLOCK);
+    waiting_ = false;
+    nextPollMono_ = 0;
+}
+
+void NtpTimeProvider::end() {
+    if (socket_ < 0) return;
+    close(socket_);
+    socket_ = -1;
+    waiting_ = false;
+}
+
+// ---- clock ------------------------------------------------------------------
+
+int64_t NtpTimeProvider::clockAt(const Model& m, uint64_t mono) {
+    int64_t elapsed = mono > m.monoBase ? (int64_t)(mono - m.monoBase) : 0;
+    int64_t maxSlew = elapsed * NTP_MAX_SLEW_PPM / 1000000;
+    int64_t slew = m.slewUs > maxSlew ? maxSlew : (m.slewUs < -maxSlew ? -maxSlew : m.slewUs);
+    return m.baseUs + elapsed + elapsed * m.freqPpb / 1000000000 + slew;
+}
+
+uint64_t NtpTimeProvider::nowMicros() const {
+    Model m = model_.read();
+    return (uint64_t)clockAt(m, monotonicMicros());
+}
+
+uint32_t NtpTimeProvider::getUnixTime() {
+    return (uint32_t)(nowMicros() / 1000000) + utcOffset_;
+}
+
+uint32_t NtpTimeProvider::getUnixUTCTime(uint32_t localTime) {
+    return localTime ? localTime - utcOffset_ : (uint32_t)(nowMicros() / 1000000);
+}
+
+int32_t NtpTimeProvider::getMillisOfDay() {
+    int64_t localMs = (int64_t)(nowMicros() / 1000) + (int64_t)utcOffset_ * 1000;
+    return (int32_t)(localMs % 86400000);
+}
+
+String NtpTimeProvider::getFormattedTime() {
+    char buf[24];
+    formatTime(buf, sizeof(buf));
+    return String(buf);
+}
+
+// ---- protocol ---------------------------------------------------------------
+
+bool NtpTimeProvider::sendRequest(uint64_t mono) {
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_);
+    if (inet_pton(AF_INET, serverIp_, &addr.sin_addr) != 1) return false;
+
+    uint8_t pkt[kPacketSize];
+    memset(pkt, 0, sizeof(pkt));
+    pkt[0] = (4 << 3) | 3;   // LI 0, version 4, mode 3 (client)
+    sentNtp_ = toNtp(clockAt(model_.read(), mono));
+    writeNtp(pkt + 40, sentNtp_);
+    if (sendto(socket_, pkt, sizeof(pkt), 0, (const sockaddr*)&addr, sizeof(addr)) < 0) {
+        return false;
+    }
+    waiting_ = true;
+    sentMono_ = mono;
+    return true;
+}
+
+bool NtpTimeProvider::receive() {
+    uint8_t pkt[kPacketSize + 16];
+    bool done = false;
+    for (;;) {
+        int n = recvfrom(socket_, pkt, sizeof(pkt), 0, nullptr, nullptr);
+        uint64_t mono = monotonicMicros();
+        if (n < 0) break;
+        if (!waiting_ || n < (int)kPacketSize) continue;
+
+        uint8_t leap = pkt[0] >> 6;
+        uint8_t mode = pkt[0] & 7;
+        uint8_t stratum = pkt[1];
+        // Unsynchronised or kiss-o'-death replies, and stale or forged ones.
+        if (mode != 4 || leap == 3 || stratum == 0 || stratum > 15) continue;
+        if (readNtp(pkt + 24) != sentNtp_) continue;
+
+        int64_t t1 = fromNtp(sentNtp_);
+        int64_t t2 = fromNtp(readNtp(pkt + 32));
+        int64_t t3 = fromNtp(readNtp(pkt + 40));
+        int64_t t4 = clockAt(model_.read(), mono);
+        int64_t offset = ((t2 - t1) + (t3 - t4)) / 2;
+        int64_t delay = (t4 - t1) - (t3 - t2);
+        waiting_ = false;
+        apply(offset, delay < 0 ? 0 : delay, mono);
+        done = true;
+    }
+    return done;
+}
+
+void NtpTimeProvider::apply(int64_t offsetUs, int64_t delayUs, uint64_t mono) {
+    Model m = model_.read();
+    int64_t now = clockAt(m, mono);
+    int64_t absOffset = offsetUs < 0 ? -offsetUs : offsetUs;
+    bool step = !synced_ || absOffset > (int64_t)NTP_STEP_THRESHOLD_MS * 1000;
+    if (step) {
+        m.baseUs = now + offsetUs;
+        m.slewUs = 0;
+        ++steps_;
+    } else {
+        // The offset is measured against the slewed clock, so it replaces
+        // whatever part of the previous correction is still pending.
+        m.baseUs = now;
+        m.slewUs = offsetUs;
+    }
+    m.monoBase = mono;
+    // Reference minus raw monotonic time; independent of our own steps.
+    drift_.addSample(mono, now + offsetUs - (int64_t)mono);
+    m.freqPpb = drift_.ppb();
+    model_.store(m);
+
+    // Jitter: RMS of successive offset differences, averaged over ~4 samples;
+    // a step restarts it.
+    if (step) {
+        jitterUs_ = 0;
+    } else if (!lastStepped_) {
+        float d = (float)(offsetUs - offsetUs_);
+        jitterUs_ = sqrtf(0.75f * jitterUs_ * jitterUs_ + 0.25f * d * d);
+    }
+
+    // Poll interval: lengthen while offsets stay within the jitter gate,
+    // shorten when they do not (as the NTP reference implementation).
+    if (!drift_.locked() && pollExp_ > NTP_MAX_POLL_EXP) pollExp_ = NTP_MAX_POLL_EXP;
+    float gate = kPollGate * (jitterUs_ > kJitterFloorUs ? jitterUs_ : kJitterFloorUs);
+    if (step) {
+        pollExp_ = NTP_MIN_POLL_EXP;
+        pollScore_ = 0;
+    } else if ((float)absOffset < gate) {
+        pollScore_ += pollExp_ + 1;
+        if (pollScore_ > kPollLimit) {
+            pollScore_ = kPollLimit;
+            if (pollExp_ < (drift_.locked() ? NTP_MAX_POLL_EXP_LOCKED : NTP_MAX_POLL_EXP)) {
+                ++pollExp_;
+                pollScore_ = 0;
+            }
+        }
+    } else {
+        pollScore_ -= 2 * (pollExp_ + 1);
+        if (pollScore_ < -kPollLimit) {
+            pollScore_ = -kPollLimit;
+            if (pollExp_ > NTP_MIN_POLL_EXP) {
+                --pollExp_;
+                pollScore_ = 0;
+            }
+        }
+    }
+
+    synced_ = true;
+    lastStepped_ = step;
+    offsetUs_ = (int32_t)(offsetUs > INT32_MAX ? INT32_MAX : offsetUs < INT32_MIN ? INT32_MIN : offsetUs);
+    delayUs_ = (uint32_t)delayUs;
+    ++syncs_;
+    nextPollMono_ = mono + ((uint64_t)1000000 << pollExp_);
+}
+
+void NtpTimeProvider::update() {
+    if (socket_ < 0) return;
+    if (receive()) return;
+    uint64_t mono = monotonicMicros();
+    if (waiting_) {
+        if (mono - sentMono_ < (uint64_t)NTP_TIMEOUT_MS * 1000) return;
+        waiting_ = false;
+        ++timeouts_;
+        nextPollMono_ = mono + (uint64_t)NTP_RETRY_S * 1000000;
+        return;
+    }
+    if (mono >= nextPollMono_ && !sendRequest(mono)) {
+        nextPollMono_ = mono + (uint64_t)NTP_RETRY_S * 1000000;
+    }
+}
+
+bool NtpTimeProvider::syncNow(uint32_t timeoutMs) {
+    if (socket_ < 0) return false;
+    uint32_t syncs = syncs_;
+    receive();   // discard anything pending
+    if (!sendRequest(monotonicMicros())) return false;
+    uint32_t start = millis();
+    while (millis() - start < timeoutMs) {
+        if (receive() && syncs_ != syncs) return true;
+        delay(1);
+    }
+    waiting_ = false;
+    ++timeouts_;
+    return false;
+}
+
+#endif // ESP32 || !ARDUINO
@@ -0,0 +1,149 @@
+#ifndef NTP_TIME_PROVIDER_H
+#define NTP_TIME_PROVIDER_H
+
+#include <TimeProviderBase.h>
+#include <SeqLock.h>
+#include <DriftCompensator.h>
+
+#ifndef NTP_MIN_POLL_EXP
+  // Shortest poll interval, 2^n seconds (64 s).
+  #define NTP_MIN_POLL_EXP 6
+#endif
+#ifndef NTP_MAX_POLL_EXP
+  // Longest poll interval, 2^n seconds (~68 min).
+  #define NTP_MAX_POLL_EXP 12
+#endif
+#ifndef NTP_MAX_POLL_EXP_LOCKED
+  // Longest poll interval once the drift estimate is locked (~4.5 h).
+  #define NTP_MAX_POLL_EXP_LOCKED 14
+#endif
+#ifndef NTP_STEP_THRESHOLD_MS
+  // Offsets above this are stepped; smaller ones are slewed.
+  #define NTP_STEP_THRESHOLD_MS 128
+#endif
+#ifndef NTP_MAX_SLEW_PPM
+  // Rate change used to slew the clock (as adjtime()).
+  #define NTP_MAX_SLEW_PPM 500
+#endif
+#ifndef NTP_TIMEOUT_MS
+  // A request without reply after this long counts as lost.
+  #define NTP_TIMEOUT_MS 2000
+#endif
+#ifndef NTP_RETRY_S
+  // Delay before asking again after a lost reply.
+  #define NTP_RETRY_S 16
+#endif
+
+/**
+ * SNTP client time provider with a disciplined clock.
+ *
+ * The clock runs on the monotonic timer. Measured offsets are removed by
+ * slewing: the clock runs up to NTP_MAX_SLEW_PPM faster or slower until the
+ * offset is absorbed, so getUnixTime() never jumps and never runs backwards.
+ * Only the first sync, or an offset above NTP_STEP_THRESHOLD_MS, steps the
+ * clock.
+ *
+ * The crystal's frequency error is estimated from the sync samples (see
+ * DriftCompensator) and applied to every read, so the clock keeps time
+ * between syncs instead of drifting by tens of ppm.
+ *
+ * The poll interval adapts between 2^NTP_MIN_POLL_EXP and 2^NTP_MAX_POLL_EXP
+ * seconds (2^NTP_MAX_POLL_EXP_LOCKED once the drift estimate is locked). It
+ * grows while the offsets stay within the measured jitter and shrinks when
+ * they do not, keeping radio wake-ups rare once settled.
+ *
+ *   static NtpTimeProvider ntp("192.168.1.1", 123, 3600);   // UTC+1
+ *   void setup() {
+ *     ... Wi-Fi up ...
+ *     ntp.begin();
+ *     ntp.syncNow();
+ *     setTimeProvider(&ntp);
+ *   }
+ *   void loop() { ntp.update(); }
+ *
+ * Uses BSD sockets (lwIP on the ESP32, POSIX on a host build), so it can be
+ * tested against tools/ntpstandin.py on localhost. Not available on the
+ * ESP8266.
+ */
+#if defined(ESP32) || !defined(ARDUINO)
+class NtpTimeProvider : public TimeProviderBase {
+public:
+    NtpTimeProvider(const char* serverIp, uint16_t port = 123, int32_t utcOffsetSeconds = 0);
+    ~NtpTimeProvider();
+
+    // Opens the (non-blocking) socket; the first request goes out on the
+    // next update().
+    void begin() override;
+    void end();
+
+    // Sends a request when the poll interval is due and processes replies.
+    // Never blocks; call it regularly, e.g. from loop().
+    void update();
+    // Sends a request now and waits up to `timeoutMs` for the reply.
+    bool syncNow(uint32_t timeoutMs = 1000);
+
+    uint32_t getUnixTime() override;
+    uint32_t getUnixUTCTime(uint32_t localTime = 0) override;
+    String getFormattedTime() override;
+    int getSecondsOfDay() override { return (int)getCalendarTime().secondOfDay; }
+    int32_t getMillisOfDay() override;
+
+    // Disciplined UTC time in microseconds since 1970.
+    uint64_t nowMicros() const;
+
+    // Statistics, updated by update()/syncNow().
+    bool synced() const { return synced_; }
+    int32_t offsetMicros() const { return offsetUs_; }     // last measured offset
+    uint32_t delayMicros() const { return delayUs_; }      // last round trip
+    uint32_t jitterMicros() const { return (uint32_t)jitterUs_; }
+    uint32_t pollIntervalSeconds() const { return 1u << pollExp_; }
+    uint32_t syncCount() const { return syncs_; }
+    uint32_t stepCount() const { return steps_; }
+    uint32_t timeoutCount() const { return timeouts_; }
+    const DriftCompensator& drift() const { return drift_; }
+
+private:
+    // time = baseUs + elapsed * (1 + freqPpb / 1e9) + slew, with
+    // |slew| <= elapsed * max rate and <= |slewUs|, elapsed counted from
+    // monoBase.
+    struct Model {
+        int64_t baseUs;
+        uint64_t monoBase;
+        int64_t slewUs;
+        int32_t freqPpb;
+    };
+
+    static int64_t clockAt(const Model& m, uint64_t mono);
+
+    bool sendRequest(uint64_t mono);
+    bool receive();
+    void apply(int64_t offsetUs, int64_t delayUs, uint64_t mono);
+
+    const char* serverIp_;
+    uint16_t port_;
+    int32_t utcOffset_;
+    int socket_ = -1;
+
+    // Single writer (update()), lock-free readers.
+    SeqLock<Model> model_{Model{ 0, 0, 0, 0 }};
+
+    bool waiting_ = false;
+    uint64_t sentMono_ = 0;
+    uint64_t sentNtp_ = 0;      // our transmit stamp, echoed as origin
+    uint64_t nextPollMono_ = 0;
+    uint8_t pollExp_ = NTP_MIN_POLL_EXP;
+    int16_t pollScore_ = 0;
+
+    bool synced_ = false;
+    bool lastStepped_ = false;
+    int32_t offsetUs_ = 0;
+    uint32_t delayUs_ = 0;
+    float jitterUs_ = 0;
+    uint32_t syncs_ = 0;
+    uint32_t steps_ = 0;
+    uint32_t timeouts_ = 0;
+    DriftCompensator drift_;
+};
+#endif // ESP32 || !ARDUINO
+
+#endif
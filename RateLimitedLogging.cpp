@@ -0,0 +1,85 @@
+#include <RateLimitedLogging.h>
+
+// ---- LogRateLimit -----------------------------------------------------------
+
+bool LogRateLimit::allow() {
+    const int32_t full = (int32_t)burst_ * 1000;
+    uint32_t now = millis();
+    uint32_t elapsed = now - lastMs_.exchange(now, std::memory_order_relaxed);
+
+    int32_t tokens = milliTokens_.load(std::memory_order_relaxed);
+    if (tokens < 0) {
+        tokens = full;
+    } else {
+        if (elapsed > 60000) elapsed = 60000; // keeps the product in range
+        tokens += (int32_t)(elapsed * perSecond_);
+        if (tokens > full) tokens = full;
+    }
+
+    bool ok = tokens >= 1000;
+    if (ok) tokens -= 1000;
+    milliTokens_.store(tokens, std::memory_order_relaxed);
+    if (!ok) suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return ok;
+}
+
+// ---- RateLimitedLogging -----------------------------------------------------
+
+RateLimitedLogging::RateLimitedLogging(LoggingBase& inner, uint16_t linesPerSecond, uint16_t burst)
+    : inner_(inner), limit_(linesPerSecond, burst), limited_(linesPerSecond > 0) {}
+
+static uint32_t lineHash(const char* data, size_t len) {
+    // FNV-1a; 0 is reserved for "no previous line"
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i) h = (h ^ (uint8_t)data[i]) * 16777619u;
+    return h ? h : 1;
+}
+
+void RateLimitedLogging::reportRepeats(uint32_t repeats) {
+    char buf[48];
+    LogFormatter f(buf, sizeof(buf));
+    f << "last message repeated " << repeats << (repeats == 1 ? " time" : " times");
+    inner_.writeln(f.data(), f.length());
+    lastReportMs_.store(millis(), std::memory_order_relaxed);
+}
+
+void RateLimitedLogging::line(LogLevel level, const char* data, size_t len) {
+    uint32_t h = lineHash(data, len);
+    if (lastHash_.load(std::memory_order_relaxed) == h &&
+        lastLen_.load(std::memory_order_relaxed) == len) {
+        repeats_.fetch_add(1, std::memory_order_relaxed);
+        if (millis() - lastReportMs_.load(std::memory_order_relaxed) >= LOG_REPEAT_REPORT_MS) {
+            uint32_t repeats = repeats_.exchange(0, std::memory_order_relaxed);
+            if (repeats) reportRepeats(repeats);
+        }
+        return;
+    }
+
+    // A line dropped here never becomes the "last message", so its own
+    // duplicates are not reported against whatever was forwarded before.
+    uint32_t dropped = 0;
+    if (limited_) {
+        if (!limit_.allow()) return;
+        dropped = limit_.takeSuppressed();
+    }
+
+    uint32_t repeats = repeats_.exchange(0, std::memory_order_relaxed);
+    if (repeats) reportRepeats(repeats);
+    lastReportMs_.store(millis(), std::memory_order_relaxed);
+    if (dropped) {
+        char buf[48];
+        LogFormatter f(buf, sizeof(buf));
+        f << dropped << " lines dropped by rate limit";
+        inner_.writeln(f.data(), f.length());
+    }
+
+    lastHash_.store(h, std::memory_order_relaxed);
+    lastLen_.store((uint32_t)len, std::memory_order_relaxed);
+    if (level != LogLevel::None) inner_.log(level, data, len);
+    else                         inner_.writeln(data, len);
+}
+
+void RateLimitedLogging::flush() {
+    uint32_t repeats = repeats_.exchange(0, std::memory_order_relaxed);
+    if (repeats) reportRepeats(repeats);
+}
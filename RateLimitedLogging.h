@@ -0,0 +1,88 @@
+#ifndef RATE_LIMITED_LOGGING_H
+#define RATE_LIMITED_LOGGING_H
+
+#include <LogLevel.h>
+#include <atomic>
+
+#ifndef LOG_REPEAT_REPORT_MS
+  // While a line keeps repeating, report the count at most this often.
+  #define LOG_REPEAT_REPORT_MS 5000
+#endif
+
+// Token bucket: refills at `perSecond` tokens per second up to `burst`.
+// Fixed size and lock-free; concurrent callers may be off by a token.
+class LogRateLimit {
+public:
+    LogRateLimit(uint16_t perSecond, uint16_t burst)
+        : perSecond_(perSecond), burst_(burst) {}
+
+    // Takes one token; counts the call as suppressed if none is left.
+    bool allow();
+    // Returns the number of suppressed calls since the last call and resets it.
+    uint32_t takeSuppressed() { return suppressed_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    uint16_t perSecond_;
+    uint16_t burst_;
+    std::atomic<int32_t> milliTokens_{-1};  // -1: not started, bucket is full
+    std::atomic<uint32_t> lastMs_{0};
+    std::atomic<uint32_t> suppressed_{0};
+};
+
+// Per call site rate limit, e.g. at most 2 lines/s with bursts of 5:
+//   LOG_RATE_LIMITED(2, 5, LogLevel::Warn, "sensor %d flapping", id);
+#define LOG_RATE_LIMITED(perSecond, burst, level, fmt, ...) do {                  \
+        static LogRateLimit _logLimit(perSecond, burst);                          \
+        if (logLevelEnabled(level) && _logLimit.allow()) {                        \
+            gLogger->logf(level, fmt, ##__VA_ARGS__);                             \
+            uint32_t _logSkipped = _logLimit.takeSuppressed();                    \
+            if (_logSkipped)                                                      \
+                gLogger->logf(level, "(%u similar lines suppressed)",             \
+                              (unsigned)_logSkipped);                            \
+        }                                                                         \
+    } while (0)
+
+/**
+ * Filtering wrapper for any backend.
+ *
+ *  - Identical consecutive lines are coalesced into
+ *    "last message repeated N times" (compared by hash and length, nothing
+ *    is copied).
+ *  - Optionally, all lines share a token bucket of `linesPerSecond`; dropped
+ *    lines are reported once output resumes.
+ *
+ * Partial output via print()/write() is passed through unfiltered.
+ */
+class RateLimitedLogging : public LoggingBase {
+public:
+    // linesPerSecond == 0 disables the rate limit (duplicate suppression only).
+    explicit RateLimitedLogging(LoggingBase& inner, uint16_t linesPerSecond = 0,
+                                uint16_t burst = 20);
+
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override { inner_.write(data, len); }
+    void writeln(const char* data, size_t len) override { line(LogLevel::None, data, len); }
+    void log(LogLevel level, const char* data, size_t len) override { line(level, data, len); }
+    bool enabled(LogLevel level) const override { return inner_.enabled(level); }
+
+    // Reports a pending repeat count now.
+    void flush();
+
+private:
+    void line(LogLevel level, const char* data, size_t len);
+    void reportRepeats(uint32_t repeats);
+
+    LoggingBase& inner_;
+    LogRateLimit limit_;
+    bool limited_;
+    std::atomic<uint32_t> lastHash_{0};
+    std::atomic<uint32_t> lastLen_{0};
+    std::atomic<uint32_t> repeats_{0};
+    std::atomic<uint32_t> lastReportMs_{0};
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#endif
+
+/**
+ * Sequence lock for a small, trivially copyable value shared between tasks:
+ * readers never block and never write shared memory.
+ *
+ * The value is held as 32-bit words in relaxed atomics, so a reader that
+ * races a writer copies well-defined (if mixed) words and the sequence check
+ * throws them away; there are no plain-field data races.
+ *
+ *   SeqLock<State> cache_;
+ *   State st;
+ *   if (!cache_.tryRead(st)) { ... compute st ...; cache_.tryPublish(st); }
+ *
+ * tryRead()/tryPublish() suit caches: both give up instead of waiting, so a
+ * reader that loses a race just recomputes. read()/store() are for a single
+ * writer whose readers must always get a value; read() spins while a store()
+ * is in progress, so on the ESP32 store() runs in a critical section and
+ * cannot be preempted on its core by a reader (task or ISR).
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+public:
+    // Empty: tryRead() fails until the first publish.
+    SeqLock() : seq_(0) { setWords(T()); }
+    explicit SeqLock(const T& value) : seq_(2) { setWords(value); }
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // False if nothing was published yet or a write is in progress.
+    bool tryRead(T& out) const {
+        uint32_t s = seq_.load(std::memory_order_acquire);
+        if (s == 0 || (s & 1)) return false;
+        uint32_t w[kWords];
+        for (size_t i = 0; i < kWords; ++i) w[i] = words_[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != s) return false;
+        memcpy(&out, w, sizeof(T));
+        return true;
+    }
+
+    // Publishes unless another task is writing right now; returns whether
+    // it did.
+    bool tryPublish(const T& value) {
+        uint32_t s = seq_.load(std::memory_order_relaxed);
+        if ((s & 1) || !seq_.compare_exchange_strong(s, s + 1, std::memory_order_relaxed)) {
+            return false;
+        }
+        write(s, value);
+        return true;
+    }
+
+    // Single writer only: concurrent store() calls corrupt the sequence.
+    // Task context only on the ESP32.
+    void store(const T& value) {
+#if defined(ESP32)
+        portENTER_CRITICAL(&mux_);
+#endif
+        uint32_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        write(s, value);
+#if defined(ESP32)
+        portEXIT_CRITICAL(&mux_);
+#endif
+    }
+
+    // Spins while a store() is in progress (on another core); needs a value
+    // to be present.
+    T read() const {
+        T value;
+        while (!tryRead(value)) {}
+        return value;
+    }
+
+private:
+    static const size_t kWords = (sizeof(T) + 3) / 4;
+
+    // Called with seq_ odd (s + 1).
+    void write(uint32_t s, const T& value) {
+        std::atomic_thread_fence(std::memory_order_release);
+        setWords(value);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    void setWords(const T& value) {
+        uint32_t w[kWords] = {0};
+        memcpy(w, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) words_[i].store(w[i], std::memory_order_relaxed);
+    }
+
+    std::atomic<uint32_t> seq_;
+    std::atomic<uint32_t> words_[kWords];
+#if defined(ESP32)
+    portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
+
+#endif
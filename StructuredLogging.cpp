@@ -0,0 +1,179 @@
+#include <StructuredLogging.h>
+
+// CBOR major types used here
+static const uint8_t kUint = 0, kNegInt = 1, kText = 3, kArray = 4;
+static const uint8_t kMapIndefinite = 0xbf, kBreak = 0xff;
+static const uint8_t kFalse = 0xf4, kTrue = 0xf5, kFloat32 = 0xfa;
+
+static size_t headSize(unsigned long long v) {
+    return v < 24 ? 1 : v <= 0xff ? 2 : v <= 0xffff ? 3 : v <= 0xffffffffull ? 5 : 9;
+}
+
+// ---- LogRecord --------------------------------------------------------------
+
+LogRecord::LogRecord(LogLevel level, const char* event, LoggingBase& out)
+    : out_(out), level_(level), active_(logLevelEnabled(level) && out.enabled(level)) {
+    if (!active_) return;
+    size_t n = strlen(event);
+    // The closing break byte of the field map is always reserved.
+    if (1 + 1 + headSize(n) + n + 1 + 1 > sizeof(buf_)) n = sizeof(buf_) - 5 - headSize(n);
+    buf_[len_++] = (uint8_t)((kArray << 5) | 3);
+    head(kUint, (uint8_t)level);
+    text(event, n);
+    buf_[len_++] = kMapIndefinite;
+}
+
+void LogRecord::head(uint8_t major, unsigned long long v) {
+    uint8_t* p = buf_ + len_;
+    size_t n = headSize(v);
+    static const uint8_t extra[] = { 0, 24, 25, 0, 26, 0, 0, 0, 27 };
+    p[0] = (uint8_t)(major << 5) | (n == 1 ? (uint8_t)v : extra[n - 1]);
+    for (size_t i = 1; i < n; ++i) p[i] = (uint8_t)(v >> (8 * (n - 1 - i)));
+    len_ += n;
+}
+
+void LogRecord::text(const char* s, size_t n) {
+    head(kText, n);
+    memcpy(buf_ + len_, s, n);
+    len_ += n;
+}
+
+bool LogRecord::field(const char* key, size_t valueSize) {
+    if (!active_) return false;
+    size_t k = strlen(key);
+    if (len_ + headSize(k) + k + valueSize + 1 > sizeof(buf_)) {
+        truncated_ = true;
+        return false;
+    }
+    text(key, k);
+    return true;
+}
+
+LogRecord& LogRecord::addInt(const char* key, long long v) {
+    if (v >= 0) return addUint(key, (unsigned long long)v);
+    unsigned long long n = (unsigned long long)(-1 - v);
+    if (field(key, headSize(n))) head(kNegInt, n);
+    return *this;
+}
+
+LogRecord& LogRecord::addUint(const char* key, unsigned long long v) {
+    if (field(key, headSize(v))) head(kUint, v);
+    return *this;
+}
+
+LogRecord& LogRecord::add(const char* key, double v) {
+    if (!field(key, 5)) return *this;
+    float f = (float)v;
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    buf_[len_++] = kFloat32;
+    for (int i = 3; i >= 0; --i) buf_[len_++] = (uint8_t)(bits >> (8 * i));
+    return *this;
+}
+
+LogRecord& LogRecord::add(const char* key, bool v) {
+    if (field(key, 1)) buf_[len_++] = v ? kTrue : kFalse;
+    return *this;
+}
+
+LogRecord& LogRecord::add(const char* key, const char* v) {
+    return addText(key, v ? v : "", v ? strlen(v) : 0);
+}
+
+LogRecord& LogRecord::addText(const char* key, const char* v, size_t n) {
+    if (field(key, headSize(n) + n)) text(v, n);
+    return *this;
+}
+
+void LogRecord::emit() {
+    if (!active_) return;
+    buf_[len_++] = kBreak;
+    out_.logRecord(level_, buf_, len_);
+    active_ = false;
+}
+
+// ---- text rendering ---------------------------------------------------------
+
+namespace {
+
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    // Reads an item head; returns false on malformed input.
+    bool head(uint8_t& major, uint8_t& info, unsigned long long& v) {
+        if (p >= end) return false;
+        major = *p >> 5;
+        info = *p & 0x1f;
+        ++p;
+        if (info < 24) {
+            v = info;
+            return true;
+        }
+        if (info > 27) {
+            v = 0; // indefinite/simple, caller decides
+            return true;
+        }
+        size_t n = (size_t)1 << (info - 24);
+        if ((size_t)(end - p) < n) return false;
+        v = 0;
+        for (size_t i = 0; i < n; ++i) v = (v << 8) | *p++;
+        return true;
+    }
+};
+
+} // namespace
+
+static bool renderValue(Reader& r, LogFormatter& out, bool quote) {
+    uint8_t major, info;
+    unsigned long long v;
+    if (!r.head(major, info, v)) return false;
+    switch (major) {
+        case kUint:
+            out.append(v);
+            return true;
+        case kNegInt:
+            out.append('-').append(v + 1);
+            return true;
+        case kText:
+            if ((unsigned long long)(r.end - r.p) < v) return false;
+            if (quote) out.append('"');
+            out.append((const char*)r.p, (size_t)v);
+            if (quote) out.append('"');
+            r.p += v;
+            return true;
+        case 7:
+            // Simple values: 20 is false, 21 is true (RFC 8949 3.3).
+            if (info == 21) { out.append("true"); return true; }
+            if (info == 20) { out.append("false"); return true; }
+            if (info == 26) {
+                uint32_t bits = (uint32_t)v;
+                float f;
+                memcpy(&f, &bits, sizeof(f));
+                out.appendf("%g", (double)f);
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+bool renderLogRecord(const uint8_t* cbor, size_t len, LogFormatter& out, LogLevel* level) {
+    Reader r = { cbor, cbor + len };
+    uint8_t major, info;
+    unsigned long long v;
+    if (!r.head(major, info, v) || major != kArray || v != 3) return false;
+    if (!r.head(major, info, v) || major != kUint) return false;
+    if (level) *level = (LogLevel)v;
+    if (!renderValue(r, out, false)) return false;
+    if (r.p >= r.end || *r.p++ != kMapIndefinite) return false;
+
+    while (r.p < r.end && *r.p != kBreak) {
+        out.append(' ');
+        if (!renderValue(r, out, false)) return false;
+        out.append('=');
+        if (!renderValue(r, out, true)) return false;
+    }
+    return r.p < r.end;
+}
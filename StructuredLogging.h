@@ -0,0 +1,74 @@
+#ifndef STRUCTURED_LOGGING_H
+#define STRUCTURED_LOGGING_H
+
+#include <LogLevel.h>
+
+#ifndef LOG_RECORD_BUFFER_SIZE
+  #define LOG_RECORD_BUFFER_SIZE 128
+#endif
+
+/**
+ * Structured key/value logging.
+ *
+ *   LogRecord(LogLevel::Info, "reading")
+ *       .add("sensor", id).add("temp", 21.5).add("ok", true)
+ *       .emit();
+ *
+ * Fields are encoded straight into a fixed CBOR buffer (RFC 8949), no
+ * Strings are built and nothing is allocated:
+ *
+ *   [ level (uint), event (text), { key: value, ... } ]
+ *
+ * with integers, float32, booleans and text strings as values. The record
+ * is handed to the backend via LoggingBase::logRecord(); binary-capable
+ * backends forward the bytes, the default renders a text line such as
+ *
+ *   reading sensor=3 temp=21.5 ok=true
+ *
+ * If the level is filtered out (LOG_LEVEL threshold, gLogLevel or the
+ * backend's enabled()) the add() calls do nothing. Fields that do not fit
+ * the buffer are dropped and the record is marked truncated.
+ */
+class LogRecord {
+public:
+    LogRecord(LogLevel level, const char* event, LoggingBase& out = *gLogger);
+
+    LogRecord& add(const char* key, int v)                { return addInt(key, v); }
+    LogRecord& add(const char* key, unsigned int v)       { return addUint(key, v); }
+    LogRecord& add(const char* key, long v)               { return addInt(key, v); }
+    LogRecord& add(const char* key, unsigned long v)      { return addUint(key, v); }
+    LogRecord& add(const char* key, long long v)          { return addInt(key, v); }
+    LogRecord& add(const char* key, unsigned long long v) { return addUint(key, v); }
+    LogRecord& add(const char* key, double v);
+    LogRecord& add(const char* key, bool v);
+    LogRecord& add(const char* key, const char* v);
+    LogRecord& add(const char* key, const String& v)      { return addText(key, v.c_str(), v.length()); }
+
+    // Closes the record and passes it to the backend given at construction.
+    void emit();
+
+    const uint8_t* data() const { return buf_; }
+    size_t length() const { return len_; }
+    bool truncated() const { return truncated_; }
+
+private:
+    LogRecord& addInt(const char* key, long long v);
+    LogRecord& addUint(const char* key, unsigned long long v);
+    LogRecord& addText(const char* key, const char* v, size_t n);
+    bool field(const char* key, size_t valueSize);
+    void head(uint8_t major, unsigned long long v);
+    void text(const char* s, size_t n);
+
+    LoggingBase& out_;
+    LogLevel level_;
+    bool active_;
+    bool truncated_ = false;
+    size_t len_ = 0;
+    uint8_t buf_[LOG_RECORD_BUFFER_SIZE];
+};
+
+// Renders a record produced by LogRecord as "event key=value ..." text.
+// Returns false if `cbor` is not such a record.
+bool renderLogRecord(const uint8_t* cbor, size_t len, LogFormatter& out, LogLevel* level = nullptr);
+
+#endif
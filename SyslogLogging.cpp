@@ -0,0 +1,131 @@
+#include <SyslogLogging.h>
+
+// BSD sockets: lwIP on the ESP32 or a POSIX host; not built for the ESP8266.
+#if defined(ESP32) || !defined(ARDUINO)
+#include <unistd.h>
+#include <fcntl.h>
+
+#if defined(ESP32)
+#include <lwip/sockets.h>
+#include <threadSafeArduino.h>
+#define SYSLOG_LOCK() threadSafe::detail::LockGuard _syslogGuard(lock_)
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#define SYSLOG_LOCK() do {} while (0)
+#endif
+
+SyslogLogging::SyslogLogging(const char* serverIp, uint16_t port, const char* hostname,
+                             const char* appName, uint8_t facility)
+    : serverIp_(serverIp), port_(port), hostname_(hostname), appName_(appName),
+      facility_(facility) {
+#if defined(ESP32)
+    lock_ = threadSafe::detail::createMutex();
+#endif
+}
+
+SyslogLogging::~SyslogLogging() {
+    end();
+}
+
+bool SyslogLogging::begin() {
+    SYSLOG_LOCK();
+    if (socket_ >= 0) return true;
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0) return false;
+    // Never block the logging task on the network stack.
+    fcntl(socket_, F_SETFL, fcntl(socket_, F_GETFL, 0) | O_NONBLOCK);
+    return true;
+}
+
+void SyslogLogging::end() {
+    SYSLOG_LOCK();
+    if (socket_ < 0) return;
+    seal();
+    sendQueued();
+    close(socket_);
+    socket_ = -1;
+}
+
+uint32_t SyslogLogging::queuedDatagrams() const {
+    return (uint8_t)(head_ + kSlots - tail_) % kSlots;
+}
+
+size_t SyslogLogging::formatHeader(LogLevel level, char* out, size_t cap) const {
+    // Severity: 3 err, 4 warning, 6 informational, 7 debug
+    static const uint8_t severity[] = { 6, 3, 4, 6, 7, 7 };
+    uint8_t i = (uint8_t)level;
+    uint8_t pri = facility_ * 8 + (i < sizeof(severity) ? severity[i] : 6);
+    LogFormatter f(out, cap);
+    f << '<' << (unsigned)pri << ">1 - " << hostname_ << ' ' << appName_ << " - - - ";
+    return f.length();
+}
+
+void SyslogLogging::append(LogLevel level, const char* data, size_t len) {
+    char header[96];
+    size_t headerLen = formatHeader(level, header, sizeof(header));
+    if (headerLen + len + 1 > SYSLOG_MAX_DATAGRAM) len = SYSLOG_MAX_DATAGRAM - headerLen - 1;
+
+    SYSLOG_LOCK();
+    if (lens_[head_] > 0 &&
+        (lens_[head_] + headerLen + len + 1 > SYSLOG_MAX_DATAGRAM ||
+         millis() - headStartMs_ >= SYSLOG_FLUSH_MS)) {
+        seal();
+        sendQueued();
+    }
+
+    char* p = datagrams_[head_] + lens_[head_];
+    if (lens_[head_] == 0) headStartMs_ = millis();
+    memcpy(p, header, headerLen);
+    memcpy(p + headerLen, data, len);
+    p[headerLen + len] = '\n';
+    lens_[head_] += headerLen + len + 1;
+#if !SYSLOG_PACK_MESSAGES
+    seal();
+    sendQueued();
+#endif
+}
+
+void SyslogLogging::seal() {
+    if (lens_[head_] == 0) return;
+    head_ = (head_ + 1) % kSlots;
+    if (head_ == tail_) {
+        // Backlog full: drop the oldest datagram.
+        lens_[tail_] = 0;
+        tail_ = (tail_ + 1) % kSlots;
+        ++dropped_;
+    }
+    lens_[head_] = 0;
+}
+
+void SyslogLogging::sendQueued() {
+    if (socket_ < 0) return;
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_);
+    if (inet_pton(AF_INET, serverIp_, &addr.sin_addr) != 1) return;
+
+    while (tail_ != head_) {
+        int sent = sendto(socket_, datagrams_[tail_], lens_[tail_], 0,
+                          (const sockaddr*)&addr, sizeof(addr));
+        if (sent < 0) break; // link down or stack busy: keep it for later
+        lens_[tail_] = 0;
+        tail_ = (tail_ + 1) % kSlots;
+    }
+}
+
+void SyslogLogging::flush() {
+    SYSLOG_LOCK();
+    seal();
+    sendQueued();
+}
+
+void SyslogLogging::update() {
+    SYSLOG_LOCK();
+    if (lens_[head_] > 0 && millis() - headStartMs_ >= SYSLOG_FLUSH_MS) seal();
+    sendQueued();
+}
+
+#endif // ESP32 || !ARDUINO
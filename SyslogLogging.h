@@ -0,0 +1,114 @@
+#ifndef SYSLOG_LOGGING_H
+#define SYSLOG_LOGGING_H
+
+#include <LoggingBase.h>
+
+#ifndef SYSLOG_MAX_DATAGRAM
+  // Payload per UDP datagram; stay below the path MTU to avoid fragmentation.
+  #define SYSLOG_MAX_DATAGRAM 1400
+#endif
+#ifndef SYSLOG_BACKLOG_DATAGRAMS
+  // Full datagrams kept while the network is down; the oldest is dropped.
+  #define SYSLOG_BACKLOG_DATAGRAMS 4
+#endif
+#ifndef SYSLOG_FLUSH_MS
+  // A partially filled datagram is sent once it is this old (checked by
+  // update() and on the next log call) or when flush() is called.
+  #define SYSLOG_FLUSH_MS 1000
+#endif
+#ifndef SYSLOG_PACK_MESSAGES
+  // 1: several messages per datagram (fewer packets, but not RFC 5426).
+  // 0: one message per datagram, sent as soon as it is logged.
+  #define SYSLOG_PACK_MESSAGES 1
+#endif
+
+/**
+ * UDP syslog backend (RFC 5424 message format).
+ *
+ * Each line becomes one message
+ *   <PRI>1 - HOSTNAME APP-NAME - - - MSG
+ * (timestamp left to the collector). Messages are packed, newline
+ * separated, into datagrams of up to SYSLOG_MAX_DATAGRAM bytes to amortise
+ * per-packet Wi-Fi overhead. If sending fails (link down) the datagram stays
+ * queued in a bounded backlog and is retried on the next flush; logging
+ * never blocks on the network.
+ *
+ * RFC 5426 allows only one message per datagram. Collectors that follow it
+ * strictly (rsyslog and syslog-ng split on newlines, others may not) see a
+ * packed datagram as one long message; build with SYSLOG_PACK_MESSAGES 0
+ * for those.
+ *
+ * Uses BSD sockets (lwIP on the ESP32, POSIX on a host build), so a
+ * localhost listener can receive the stream in tests. Not available on the
+ * ESP8266.
+ *
+ *   static SyslogLogging syslog("192.168.1.10", 514, "node-7", "app");
+ *   syslog.begin();   // after Wi-Fi is up
+ *   void loop() { syslog.update(); ... }
+ *
+ * Without update() a quiet logger holds its last messages until the next
+ * log call.
+ *
+ * print()/write() output is sent as its own message; wrap the backend in a
+ * LineBufferedLogging to join partial lines.
+ */
+#if defined(ESP32) || !defined(ARDUINO)
+class SyslogLogging : public LoggingBase {
+public:
+    // Facility 16 = local0.
+    SyslogLogging(const char* serverIp, uint16_t port = 514, const char* hostname = "esp32",
+                  const char* appName = "espcore", uint8_t facility = 16);
+    ~SyslogLogging();
+
+    bool begin();
+    void end();
+
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override { append(LogLevel::None, data, len); }
+    void writeln(const char* data, size_t len) override { append(LogLevel::None, data, len); }
+    void log(LogLevel level, const char* data, size_t len) override { append(level, data, len); }
+
+    // Seals the current datagram and sends everything queued.
+    void flush();
+
+    // Sends the current datagram once it is SYSLOG_FLUSH_MS old and retries
+    // the backlog; call it regularly, e.g. from loop().
+    void update();
+
+    uint32_t droppedDatagrams() const { return dropped_; }
+    uint32_t queuedDatagrams() const;
+
+private:
+    void append(LogLevel level, const char* data, size_t len);
+    void seal();
+    void sendQueued();
+    size_t formatHeader(LogLevel level, char* out, size_t cap) const;
+
+    const char* serverIp_;
+    uint16_t port_;
+    const char* hostname_;
+    const char* appName_;
+    uint8_t facility_;
+    int socket_ = -1;
+
+    // Ring of datagrams: [tail_, head_) are sealed and waiting to be sent,
+    // head_ is the one being filled.
+    static const uint8_t kSlots = SYSLOG_BACKLOG_DATAGRAMS + 1;
+    char datagrams_[kSlots][SYSLOG_MAX_DATAGRAM];
+    uint16_t lens_[kSlots] = {0};
+    uint8_t head_ = 0;
+    uint8_t tail_ = 0;
+    uint32_t headStartMs_ = 0;
+    uint32_t dropped_ = 0;
+
+#if defined(ESP32)
+    SemaphoreHandle_t lock_;
+#endif
+};
+#endif // ESP32 || !ARDUINO
+
+#endif
@@ -0,0 +1,71 @@
+#include <TeeLogging.h>
+
+// A sink set to None is muted for every line, None-level ones included.
+static inline bool sinkAccepts(uint8_t sinkLevel, LogLevel level) {
+    return sinkLevel != (uint8_t)LogLevel::None && (uint8_t)level <= sinkLevel;
+}
+
+bool TeeLogging::addSink(LoggingBase& sink, LogLevel level) {
+    // Adding is expected during setup; the count is published last so
+    // concurrent loggers only see fully initialised slots.
+    uint8_t n = count_.load(std::memory_order_relaxed);
+    if (n >= LOG_TEE_MAX_SINKS) return false;
+    sinks_[n].logger = &sink;
+    sinks_[n].level.store((uint8_t)level, std::memory_order_relaxed);
+    count_.store(n + 1, std::memory_order_release);
+    return true;
+}
+
+bool TeeLogging::setSinkLevel(LoggingBase& sink, LogLevel level) {
+    uint8_t n = count_.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; ++i) {
+        if (sinks_[i].logger == &sink) {
+            sinks_[i].level.store((uint8_t)level, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TeeLogging::write(const char* data, size_t len) {
+    uint8_t n = count_.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; ++i) {
+        if (sinks_[i].level.load(std::memory_order_relaxed) != (uint8_t)LogLevel::None)
+            sinks_[i].logger->write(data, len);
+    }
+}
+
+void TeeLogging::writeln(const char* data, size_t len) {
+    uint8_t n = count_.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; ++i) {
+        if (sinks_[i].level.load(std::memory_order_relaxed) != (uint8_t)LogLevel::None)
+            sinks_[i].logger->writeln(data, len);
+    }
+}
+
+void TeeLogging::logRecord(LogLevel level, const uint8_t* cbor, size_t len) {
+    // Binary-capable sinks get the record itself, the others render it.
+    uint8_t n = count_.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; ++i) {
+        if (sinkAccepts(sinks_[i].level.load(std::memory_order_relaxed), level))
+            sinks_[i].logger->logRecord(level, cbor, len);
+    }
+}
+
+bool TeeLogging::enabled(LogLevel level) const {
+    uint8_t n = count_.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; ++i) {
+        if (sinkAccepts(sinks_[i].level.load(std::memory_order_relaxed), level) &&
+            sinks_[i].logger->enabled(level))
+            return true;
+    }
+    return false;
+}
+
+void TeeLogging::log(LogLevel level, const char* data, size_t len) {
+    uint8_t n = count_.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; ++i) {
+        if (sinkAccepts(sinks_[i].level.load(std::memory_order_relaxed), level))
+            sinks_[i].logger->log(level, data, len);
+    }
+}
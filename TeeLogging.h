@@ -0,0 +1,57 @@
+#ifndef TEE_LOGGING_H
+#define TEE_LOGGING_H
+
+#include <LoggingBase.h>
+#include <atomic>
+
+#ifndef LOG_TEE_MAX_SINKS
+  #define LOG_TEE_MAX_SINKS 4
+#endif
+
+/**
+ * Fan-out backend: every message is formatted once (by LoggingBase) and the
+ * same buffer is handed to each sink in turn.
+ *
+ * Each sink has its own level threshold for level-tagged lines (log()/LOG_xxx);
+ * untagged print/println output goes to all sinks that are not set to None.
+ *
+ * Sinks are called synchronously. Wrap a slow sink (flash, network) in its
+ * own AsyncLogging so it gets an independent queue: it then drops its own
+ * messages when it falls behind instead of stalling the other sinks.
+ *
+ *   static SerialLogging serialSink;
+ *   static AsyncLogging  netQueue(syslogSink);
+ *   static TeeLogging    tee;
+ *   tee.addSink(serialSink, LogLevel::Info);
+ *   tee.addSink(netQueue, LogLevel::Warn);
+ *   setLogger(&tee);
+ */
+class TeeLogging : public LoggingBase {
+public:
+    // Returns false if all LOG_TEE_MAX_SINKS slots are taken.
+    bool addSink(LoggingBase& sink, LogLevel level = LogLevel::Trace);
+    // Returns false if `sink` was never added. LogLevel::None mutes it.
+    bool setSinkLevel(LoggingBase& sink, LogLevel level);
+
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override;
+    void writeln(const char* data, size_t len) override;
+    void log(LogLevel level, const char* data, size_t len) override;
+    void logRecord(LogLevel level, const uint8_t* cbor, size_t len) override;
+    bool enabled(LogLevel level) const override;
+
+private:
+    struct Sink {
+        LoggingBase* logger;
+        std::atomic<uint8_t> level;
+    };
+
+    Sink sinks_[LOG_TEE_MAX_SINKS];
+    std::atomic<uint8_t> count_{0};
+};
+
+#endif
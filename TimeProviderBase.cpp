@@ -1,11 +1,127 @@
-
 #include <TimeProviderBase.h>
 
-TimeProviderBase* gTimeProvider;
 NullTimeProvider gNullTimeProvider;
+TimeProviderBase* gTimeProvider = &gNullTimeProvider;
 
 void setTimeProvider(TimeProviderBase* timeProvider) {
-    if(timeProvider == 0)
-         gTimeProvider = &gNullTimeProvider;
-    gTimeProvider = timeProvider;
-}
\ No newline at end of file
+    gTimeProvider = timeProvider ? timeProvider : &gNullTimeProvider;
+}
+
+// ---- formatting -------------------------------------------------------------
+
+static const char kTwoDigits[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+void TimeProviderBase::civilFromDays(uint32_t days, uint16_t& year, uint8_t& month, uint8_t& day) {
+    // Days to civil date in 400-year eras starting on March 1st.
+    uint32_t z = days + 719468;
+    uint32_t era = z / 146097;
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    day = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+    month = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+    year = (uint16_t)(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+size_t TimeProviderBase::formatTime(char* buf, size_t cap, const char* layout) {
+    return formatTime(getUnixTime(), buf, cap, layout);
+}
+
+size_t TimeProviderBase::formatTime(uint32_t unixTime, char* buf, size_t cap, const char* layout) {
+    if (cap == 0) return 0;
+    CalendarTime tm = calendar_.get(unixTime);
+    uint32_t year = tm.year;
+
+    size_t n = 0;
+    const size_t last = cap - 1;
+    for (const char* p = layout; *p && n < last; ++p) {
+        if (*p != '%' || !p[1]) {
+            buf[n++] = *p;
+            continue;
+        }
+        char field[4];
+        size_t w = 2;
+        switch (*++p) {
+            case 'Y':
+                memcpy(field, kTwoDigits + 2 * (year / 100 % 100), 2);
+                memcpy(field + 2, kTwoDigits + 2 * (year % 100), 2);
+                w = 4;
+                break;
+            case 'm': memcpy(field, kTwoDigits + 2 * tm.month, 2); break;
+            case 'd': memcpy(field, kTwoDigits + 2 * tm.day, 2); break;
+            case 'H': memcpy(field, kTwoDigits + 2 * tm.hour, 2); break;
+            case 'M': memcpy(field, kTwoDigits + 2 * tm.minute, 2); break;
+            case 'S': memcpy(field, kTwoDigits + 2 * tm.second, 2); break;
+            case '%': w = 1; field[0] = '%'; break;
+            default:  field[0] = '%'; field[1] = *p; break;
+        }
+        if (n + w > last) break;
+        memcpy(buf + n, field, w);
+        n += w;
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+// ---- CalendarCache ----------------------------------------------------------
+
+static uint8_t daysInMonth(uint8_t month, uint16_t year) {
+    static const uint8_t kDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month == 2 && (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))) return 29;
+    return kDays[month - 1];
+}
+
+CalendarTime CalendarCache::compute(uint32_t unixTime) {
+    CalendarTime tm;
+    uint32_t days = unixTime / 86400;
+    uint32_t sod = unixTime - days * 86400;
+    TimeProviderBase::civilFromDays(days, tm.year, tm.month, tm.day);
+    tm.secondOfDay = sod;
+    tm.hour = (uint8_t)(sod / 3600);
+    tm.minute = (uint8_t)(sod / 60 % 60);
+    tm.second = (uint8_t)(sod % 60);
+    return tm;
+}
+
+bool CalendarCache::advance(State& st, uint32_t unixTime) {
+    if (unixTime < st.unixTime || unixTime - st.unixTime > CALENDAR_CACHE_MAX_STEP) return false;
+    uint32_t step = unixTime - st.unixTime;
+    if (step == 0) return true;
+    CalendarTime& tm = st.tm;
+    st.unixTime = unixTime;
+
+    tm.secondOfDay += step;
+    if (tm.secondOfDay >= 86400) tm.secondOfDay -= 86400;
+    uint32_t second = tm.second + step;
+    while (second >= 60) {
+        second -= 60;
+        if (++tm.minute < 60) continue;
+        tm.minute = 0;
+        if (++tm.hour < 24) continue;
+        tm.hour = 0;
+        if (++tm.day <= daysInMonth(tm.month, tm.year)) continue;
+        tm.day = 1;
+        if (++tm.month <= 12) continue;
+        tm.month = 1;
+        ++tm.year;
+    }
+    tm.second = (uint8_t)second;
+    return true;
+}
+
+CalendarTime CalendarCache::get(uint32_t unixTime) {
+    State st;
+    bool hit = state_.tryRead(st);
+    if (hit && st.unixTime == unixTime) return st.tm;
+    if (!hit || !advance(st, unixTime)) {
+        st.unixTime = unixTime;
+        st.tm = compute(unixTime);
+    }
+    // Skipped if another task is already updating the cache.
+    state_.tryPublish(st);
+    return st.tm;
+}
@@ -2,6 +2,54 @@
 #define TIME_PROVIDER_BASE_H
 
 #include <Arduino.h>
+#include <SeqLock.h>
+
+#if defined(ESP32)
+#include <esp_timer.h>
+#elif !defined(ESP8266)
+#include <time.h>
+#endif
+
+// Layout tokens for formatTime(): %Y %m %d %H %M %S and %%; any other
+// character is copied as is.
+#define TIME_FORMAT_ISO8601 "%Y-%m-%dT%H:%M:%S"
+
+#ifndef CALENDAR_CACHE_MAX_STEP
+  // Largest forward step (s) applied incrementally; bigger jumps and any
+  // backward step recompute the calendar from scratch.
+  #define CALENDAR_CACHE_MAX_STEP 900
+#endif
+
+struct CalendarTime {
+    uint16_t year;
+    uint8_t month;          // 1..12
+    uint8_t day;            // 1..31
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint32_t secondOfDay;
+};
+
+// Broken-down time of the last query, advanced from there on the next one,
+// so following a clock costs a subtraction and a few compares instead of
+// divisions and a days-to-date conversion. Safe to share between tasks.
+class CalendarCache {
+public:
+    CalendarTime get(uint32_t unixTime);
+
+    // Full conversion, no cache.
+    static CalendarTime compute(uint32_t unixTime);
+
+private:
+    struct State {
+        uint32_t unixTime;
+        CalendarTime tm;
+    };
+    static bool advance(State& st, uint32_t unixTime);
+
+    // Last result, shared lock-free between tasks.
+    SeqLock<State> state_;
+};
 
 class TimeProviderBase {
 public:
@@ -14,27 +62,67 @@ public:
     virtual String getFormattedTime() = 0;
 
     virtual int getSecondsOfDay() = 0;
+
+    // Milliseconds since local midnight from a single clock reading.
+    // Providers without sub-second resolution can keep this default, which
+    // reports whole seconds.
+    virtual int32_t getMillisOfDay() { return (int32_t)getSecondsOfDay() * 1000; }
+
+    // Time since boot that never wraps or jumps (unaffected by time syncs);
+    // use it for intervals. Lock-free: one timer read.
+    static uint64_t monotonicMicros() {
+#if defined(ESP32)
+        return (uint64_t)esp_timer_get_time();
+#elif defined(ESP8266)
+        return micros64();
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+#endif
+    }
+    static uint64_t monotonicMillis() { return monotonicMicros() / 1000u; }
+
+    // Current local time, broken down via the calendar cache.
+    CalendarTime getCalendarTime() { return calendar_.get(getUnixTime()); }
+
+    // Allocation-free alternative to getFormattedTime(): writes getUnixTime()
+    // into `buf` (always NUL-terminated, cut at `cap`) and returns the length.
+    //   char ts[24];
+    //   gTimeProvider->formatTime(ts, sizeof(ts));   // "2024-05-01T13:37:00"
+    size_t formatTime(char* buf, size_t cap, const char* layout = TIME_FORMAT_ISO8601);
+    size_t formatTime(uint32_t unixTime, char* buf, size_t cap,
+                      const char* layout = TIME_FORMAT_ISO8601);
+
+    // Days since 1970-01-01 to a proleptic Gregorian date.
+    static void civilFromDays(uint32_t days, uint16_t& year, uint8_t& month, uint8_t& day);
+
+private:
+    CalendarCache calendar_;
 };
 
-//just uses millis()
+// No wall clock: reports seconds since boot from the monotonic clock.
 class NullTimeProvider : public TimeProviderBase {
 public:
     void begin() override {}
     
     uint32_t getUnixTime() override {
-        return millis();
+        return (uint32_t)(monotonicMicros() / 1000000u);
     }
     
     uint32_t getUnixUTCTime(uint32_t localTime=0) override {
         return localTime;
     }
     String getFormattedTime() override {
-        return String(millis()/1000);
+        return String(getUnixTime());
     }
 
     int getSecondsOfDay() override { //wraps at 24h
-        int secs = millis() / 1000;
-        return secs % 86400; // 24 * 60 * 60
+        return (int)getCalendarTime().secondOfDay;
+    }
+
+    int32_t getMillisOfDay() override {
+        return (int32_t)(monotonicMillis() % 86400000u);
     }
 
 };
@@ -0,0 +1,70 @@
+#include <TimestampLogging.h>
+
+static inline void put2(char* p, uint32_t v) {
+    p[0] = char('0' + v / 10);
+    p[1] = char('0' + v % 10);
+}
+
+void TimestampLogging::formatPrefix(char* out) {
+    TimeProviderBase* time = time_ ? time_ : gTimeProvider;
+    int32_t msOfDay = time->getMillisOfDay();
+    int32_t second = msOfDay / 1000;
+
+    // Fast path: copy the cached "HH:MM:SS." if it is for this second.
+    CachedSecond c;
+    if (cached_.tryRead(c) && c.second == second) {
+        memcpy(out, c.hms, 9);
+    } else {
+        c.second = second;
+        put2(c.hms, second / 3600);
+        c.hms[2] = ':';
+        put2(c.hms + 3, second / 60 % 60);
+        c.hms[5] = ':';
+        put2(c.hms + 6, second % 60);
+        c.hms[8] = '.';
+        memcpy(out, c.hms, 9);
+        // Skipped if another task is already updating the cache.
+        cached_.tryPublish(c);
+    }
+
+    uint32_t ms = (uint32_t)(msOfDay % 1000);
+    out[9] = char('0' + ms / 100);
+    put2(out + 10, ms % 100);
+    out[12] = ' ';
+}
+
+void TimestampLogging::emit(Kind kind, LogLevel level, const char* data, size_t len) {
+    char line[kPrefixLen + LOGGING_LINE_BUFFER_SIZE];
+    size_t n = 0;
+    if (atLineStart_.exchange(kind != Write, std::memory_order_relaxed)) {
+        formatPrefix(line);
+        n = kPrefixLen;
+    }
+
+    if (len > sizeof(line) - n) {
+        // Too long to copy: the prefix goes on its own, then the line uncut.
+        if (n > 0) inner_.write(line, n);
+    } else {
+        memcpy(line + n, data, len);
+        data = line;
+        len += n;
+    }
+
+    switch (kind) {
+        case Write:   inner_.write(data, len); break;
+        case Writeln: inner_.writeln(data, len); break;
+        case Log:     inner_.log(level, data, len); break;
+    }
+}
+
+void TimestampLogging::write(const char* data, size_t len) {
+    emit(Write, LogLevel::None, data, len);
+}
+
+void TimestampLogging::writeln(const char* data, size_t len) {
+    emit(Writeln, LogLevel::None, data, len);
+}
+
+void TimestampLogging::log(LogLevel level, const char* data, size_t len) {
+    emit(Log, level, data, len);
+}
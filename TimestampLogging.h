@@ -0,0 +1,59 @@
+#ifndef TIMESTAMP_LOGGING_H
+#define TIMESTAMP_LOGGING_H
+
+#include <LoggingBase.h>
+#include <TimeProviderBase.h>
+#include <SeqLock.h>
+#include <atomic>
+
+/**
+ * Prefixes every line with the time of day, "HH:MM:SS.mmm ", and forwards it
+ * to the wrapped backend as one write (two for lines longer than
+ * LOGGING_LINE_BUFFER_SIZE, which are passed through uncut).
+ *
+ * The time comes from the provider's getMillisOfDay() (gTimeProvider unless
+ * one is given); providers without sub-second resolution print ".000". The
+ * "HH:MM:SS." part is cached and only reformatted when the second changes;
+ * per line just the three millisecond digits are patched in.
+ *
+ *   static SerialLogging    serialSink;
+ *   static TimestampLogging stamped(serialSink);
+ *   setLogger(&stamped);
+ */
+class TimestampLogging : public LoggingBase {
+public:
+    explicit TimestampLogging(LoggingBase& inner, TimeProviderBase* time = nullptr)
+        : inner_(inner), time_(time) {}
+
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override;
+    void writeln(const char* data, size_t len) override;
+    void log(LogLevel level, const char* data, size_t len) override;
+    bool enabled(LogLevel level) const override { return inner_.enabled(level); }
+
+    static const size_t kPrefixLen = 13; // "HH:MM:SS.mmm "
+
+    // Writes the current prefix (kPrefixLen chars, no NUL) to `out`.
+    void formatPrefix(char* out);
+
+private:
+    enum Kind { Write, Writeln, Log };
+    void emit(Kind kind, LogLevel level, const char* data, size_t len);
+
+    LoggingBase& inner_;
+    TimeProviderBase* time_;
+    std::atomic<bool> atLineStart_{true};
+
+    // Formatted "HH:MM:SS." of the last second seen, shared between tasks.
+    struct CachedSecond {
+        int32_t second;
+        char hms[9];
+    };
+    SeqLock<CachedSecond> cached_;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include <TokenizedLogging.h>
+
+namespace logtoken {
+
+static const char kBase64[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+Encoder::Encoder(uint32_t token) : len_(4) {
+    buf_[0] = (uint8_t)token;
+    buf_[1] = (uint8_t)(token >> 8);
+    buf_[2] = (uint8_t)(token >> 16);
+    buf_[3] = (uint8_t)(token >> 24);
+}
+
+void Encoder::addSigned(long long v) {
+    uint8_t tmp[10];
+    size_t n = 0;
+    unsigned long long z = ((unsigned long long)v << 1) ^ (unsigned long long)(v >> 63);
+    do {
+        uint8_t b = z & 0x7f;
+        z >>= 7;
+        tmp[n++] = z ? (b | 0x80) : b;
+    } while (z);
+    if (full_ || len_ + n > sizeof(buf_)) {
+        full_ = true;
+        return;
+    }
+    memcpy(buf_ + len_, tmp, n);
+    len_ += n;
+}
+
+void Encoder::add(double v) {
+    float f = (float)v;
+    if (full_ || len_ + sizeof(f) > sizeof(buf_)) {
+        full_ = true;
+        return;
+    }
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    for (int i = 0; i < 4; ++i) buf_[len_++] = (uint8_t)(bits >> (8 * i));
+}
+
+void Encoder::add(const char* s) {
+    addString(s, s ? strlen(s) : 0);
+}
+
+void Encoder::addString(const char* s, size_t n) {
+    if (full_ || len_ + 1 > sizeof(buf_)) {
+        full_ = true;
+        return;
+    }
+    // Cut to what is left rather than dropping it; the length byte says how
+    // much was kept, so the decoder stays in step.
+    if (n > TOKENIZED_LOG_MAX_STRING) n = TOKENIZED_LOG_MAX_STRING;
+    if (n > sizeof(buf_) - len_ - 1) {
+        n = sizeof(buf_) - len_ - 1;
+        full_ = true;
+    }
+    buf_[len_++] = (uint8_t)n;
+    memcpy(buf_ + len_, s, n);
+    len_ += n;
+}
+
+void Encoder::emit(LoggingBase& out) const {
+    char line[1 + (TOKENIZED_LOG_MAX_PAYLOAD + 2) / 3 * 4];
+    size_t n = 0;
+    line[n++] = '$';
+    for (size_t i = 0; i < len_; i += 3) {
+        uint32_t v = (uint32_t)buf_[i] << 16;
+        if (i + 1 < len_) v |= (uint32_t)buf_[i + 1] << 8;
+        if (i + 2 < len_) v |= buf_[i + 2];
+        line[n++] = kBase64[(v >> 18) & 0x3f];
+        line[n++] = kBase64[(v >> 12) & 0x3f];
+        line[n++] = i + 1 < len_ ? kBase64[(v >> 6) & 0x3f] : '=';
+        line[n++] = i + 2 < len_ ? kBase64[v & 0x3f] : '=';
+    }
+    out.writeln(line, n);
+}
+
+} // namespace logtoken
@@ -0,0 +1,95 @@
+#ifndef TOKENIZED_LOGGING_H
+#define TOKENIZED_LOGGING_H
+
+#include <LoggingBase.h>
+
+/**
+ * Tokenized binary logging.
+ *
+ * LOG_TOKENIZED(fmt, args...) replaces the format string by its 32-bit
+ * FNV-1a hash, computed at compile time, so the string itself never ends up
+ * in flash. The token and the packed arguments are sent through gLogger as
+ * one text-safe line:  '$' + base64(token LE32, args...).
+ *
+ * Argument encoding (no snprintf on the device):
+ *  - integers, bool, char, pointers: zig-zag varint
+ *  - float/double:                   IEEE-754 float, little endian
+ *  - const char* / String:           length byte + bytes, cut to
+ *                                    TOKENIZED_LOG_MAX_STRING and to the
+ *                                    space left in the record
+ *
+ * tools/logtokens.py builds the token database from the sources and turns a
+ * captured stream back into text:
+ *   python3 tools/logtokens.py database src/ > tokens.csv
+ *   python3 tools/logtokens.py decode tokens.csv < capture.txt
+ *
+ * The format string must be a string literal written directly in the macro
+ * call so the database tool can find it.
+ */
+
+#ifndef TOKENIZED_LOG_MAX_PAYLOAD
+  #define TOKENIZED_LOG_MAX_PAYLOAD 48
+#endif
+#ifndef TOKENIZED_LOG_MAX_STRING
+  // Longest string argument kept; by default all the payload after the
+  // token and the length byte. Longer strings are cut, not dropped.
+  #define TOKENIZED_LOG_MAX_STRING (TOKENIZED_LOG_MAX_PAYLOAD - 5)
+#endif
+static_assert(TOKENIZED_LOG_MAX_STRING <= 255, "string length must fit its length byte");
+
+namespace logtoken {
+
+// FNV-1a over the format string; must match tools/logtokens.py.
+constexpr uint32_t hash(const char* s, uint32_t h = 2166136261u) {
+    return *s ? hash(s + 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+}
+
+// Packs one tokenized record; a string that does not fit is cut, other
+// arguments that no longer fit are dropped (with everything after them).
+class Encoder {
+public:
+    explicit Encoder(uint32_t token);
+
+    void add(int v)                { addSigned(v); }
+    void add(unsigned int v)       { addSigned((long long)v); }
+    void add(long v)               { addSigned(v); }
+    void add(unsigned long v)      { addSigned((long long)v); }
+    void add(long long v)          { addSigned(v); }
+    void add(unsigned long long v) { addSigned((long long)v); }
+    void add(char v)               { addSigned(v); }
+    void add(bool v)               { addSigned(v ? 1 : 0); }
+    void add(double v);
+    void add(const char* s);
+    void add(const String& s)      { addString(s.c_str(), s.length()); }
+    void add(const void* p)        { addSigned((long long)(uintptr_t)p); }
+
+    // Sends '$' + base64(record) as one line.
+    void emit(LoggingBase& out) const;
+
+private:
+    void addSigned(long long v);
+    void addString(const char* s, size_t n);
+
+    uint8_t buf_[TOKENIZED_LOG_MAX_PAYLOAD];
+    size_t len_;
+    bool full_ = false; // once an argument is cut, later ones are dropped too
+};
+
+inline void encodeArgs(Encoder&) {}
+
+template <typename T, typename... Rest>
+inline void encodeArgs(Encoder& e, const T& value, const Rest&... rest) {
+    e.add(value);
+    encodeArgs(e, rest...);
+}
+
+} // namespace logtoken
+
+#define LOG_TOKENIZED(fmt, ...) do {                              \
+        constexpr uint32_t _logToken = ::logtoken::hash(fmt);     \
+        ::logtoken::Encoder _logEnc(_logToken);                   \
+        ::logtoken::encodeArgs(_logEnc, ##__VA_ARGS__);           \
+        _logEnc.emit(*gLogger);                                   \
+    } while (0)
+
+#endif
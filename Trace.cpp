@@ -0,0 +1,96 @@
+#include <Trace.h>
+
+#if defined(ESPCORE_TRACE)
+#include <atomic>
+
+static_assert((TRACE_EVENTS_PER_CORE & (TRACE_EVENTS_PER_CORE - 1)) == 0,
+              "TRACE_EVENTS_PER_CORE must be a power of two");
+
+#if defined(ESP32)
+static const int kTraceCores = portNUM_PROCESSORS;
+static inline int traceCore() { return xPortGetCoreID(); }
+static inline uint32_t traceThread() { return (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle(); }
+#else
+#include <functional>
+#include <thread>
+static const int kTraceCores = 1;
+static inline int traceCore() { return 0; }
+static inline uint32_t traceThread() {
+    return (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+#endif
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    uint32_t startUs;
+    uint32_t durUs;
+    uint32_t thread;
+};
+
+struct TraceRing {
+    std::atomic<uint32_t> next{0};
+    TraceEvent events[TRACE_EVENTS_PER_CORE];
+};
+
+TraceRing _rings[kTraceCores];
+std::atomic<bool> _traceEnabled{true};
+
+} // namespace
+
+TraceSpan::~TraceSpan() {
+    uint32_t endUs = micros();
+    if (!_traceEnabled.load(std::memory_order_relaxed)) return;
+    TraceRing& ring = _rings[traceCore()];
+    uint32_t i = ring.next.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent& e = ring.events[i & (TRACE_EVENTS_PER_CORE - 1)];
+    e.name = name_;
+    e.startUs = startUs_;
+    e.durUs = endUs - startUs_;
+    e.thread = traceThread();
+}
+
+void traceEnable(bool enabled) {
+    _traceEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void traceClear() {
+    for (TraceRing& ring : _rings) ring.next.store(0, std::memory_order_relaxed);
+}
+
+// Calls emit(line, len) for the opening bracket, each event and the close.
+template <typename Emit>
+static void traceEmit(Emit emit) {
+    char buf[LOGGING_LINE_BUFFER_SIZE];
+    emit("[", 1);
+    bool first = true;
+    for (int core = 0; core < kTraceCores; ++core) {
+        TraceRing& ring = _rings[core];
+        uint32_t end = ring.next.load(std::memory_order_acquire);
+        uint32_t begin = end > TRACE_EVENTS_PER_CORE ? end - TRACE_EVENTS_PER_CORE : 0;
+        for (uint32_t i = begin; i < end; ++i) {
+            const TraceEvent& e = ring.events[i & (TRACE_EVENTS_PER_CORE - 1)];
+            LogFormatter f(buf, sizeof(buf));
+            if (!first) f.append(',');
+            f << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"ts\":" << e.startUs
+              << ",\"dur\":" << e.durUs << ",\"pid\":" << core << ",\"tid\":" << e.thread << '}';
+            emit(f.data(), f.length());
+            first = false;
+        }
+    }
+    emit("]", 1);
+}
+
+void traceDump(LoggingBase& out) {
+    traceEmit([&](const char* line, size_t len) { out.writeln(line, len); });
+}
+
+void traceDump(FILE* out) {
+    traceEmit([&](const char* line, size_t len) {
+        fwrite(line, 1, len, out);
+        fputc('\n', out);
+    });
+}
+
+#endif
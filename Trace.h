@@ -0,0 +1,73 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <LoggingBase.h>
+#include <stdio.h>
+
+/**
+ * Scoped tracing spans with Chrome trace-event export.
+ *
+ *   void loop() {
+ *     TRACE_SCOPE("loop");
+ *     { TRACE_SCOPE("read sensors"); readSensors(); }
+ *     ...
+ *   }
+ *   traceDump(*gLogger);   // or traceDump(file) on a host build
+ *
+ * Load the dump in chrome://tracing or ui.perfetto.dev.
+ *
+ * Spans record begin time and duration (micros()) into a fixed ring per
+ * core; the oldest spans are overwritten. A span costs two clock reads and
+ * one atomic increment. Enable with the build flag -DESPCORE_TRACE (it must
+ * be seen by the library sources too); without it TRACE_SCOPE and
+ * TRACE_FUNCTION expand to nothing.
+ *
+ * `name` must outlive the dump (string literals).
+ */
+
+#ifndef TRACE_EVENTS_PER_CORE
+  // Must be a power of two.
+  #define TRACE_EVENTS_PER_CORE 256
+#endif
+
+#if defined(ESPCORE_TRACE)
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) : name_(name), startUs_(micros()) {}
+    ~TraceSpan();
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    uint32_t startUs_;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceSpan TRACE_CONCAT(_traceSpan, __LINE__)(name)
+#define TRACE_FUNCTION() TRACE_SCOPE(__func__)
+
+// Pauses/resumes recording, e.g. around a dump.
+void traceEnable(bool enabled);
+void traceClear();
+
+// Writes all recorded spans as a Chrome trace-event JSON array, one event
+// per line. Pause recording first for a consistent snapshot.
+void traceDump(LoggingBase& out);
+void traceDump(FILE* out);
+
+#else
+
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_FUNCTION() do {} while (0)
+
+inline void traceEnable(bool) {}
+inline void traceClear() {}
+inline void traceDump(LoggingBase&) {}
+inline void traceDump(FILE*) {}
+
+#endif
+
+#endif
@@ -0,0 +1,484 @@
+#include "LoggingBenchmark.h"
+#include <CompressedLogging.h>
+#include <LineBufferedLogging.h>
+#include <atomic>
+#include <memory>
+
+#if defined(ESP32)
+#include <freertos/semphr.h>
+#elif !defined(ARDUINO)
+#include <chrono>
+#include <mutex>
+#include <new>
+#include <thread>
+#endif
+
+// ---- allocation counting ----------------------------------------------------
+
+#if defined(ESP32) || defined(ARDUINO)
+#define LOG_BENCH_ALLOCS_KEY "adapter_allocs_per_call"
+static inline uint32_t benchAllocations() { return LoggingBase::adapterAllocations(); }
+static inline void benchCountAllocations(bool) {}
+#else
+#define LOG_BENCH_ALLOCS_KEY "allocs_per_call"
+// Only threads that are being measured count, so the runner's own setup
+// (thread start-up, result buffers) stays out of the figures.
+static std::atomic<uint32_t> _benchAllocations{0};
+static thread_local bool _benchCounting = false;
+
+static inline uint32_t benchAllocations() { return _benchAllocations.load(); }
+static inline void benchCountAllocations(bool on) { _benchCounting = on; }
+
+// Replaces the program's global operator new. noinline: once inlined, GCC
+// sees free() paired with new and warns (-Wmismatched-new-delete).
+__attribute__((noinline)) void* operator new(size_t size) {
+    if (_benchCounting) _benchAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { free(p); }
+#endif
+
+// ---- clocks -----------------------------------------------------------------
+
+#if defined(ESP32)
+// Cycle counter for per-call latency (tasks are pinned, so it stays per core).
+static inline uint32_t benchStamp() { return ESP.getCycleCount(); }
+static inline uint32_t benchNs(uint32_t from, uint32_t to) {
+    return (uint32_t)((uint64_t)(to - from) * 1000 / getCpuFrequencyMhz());
+}
+static inline uint64_t benchWallNs() { return (uint64_t)esp_timer_get_time() * 1000; }
+#elif defined(ARDUINO)
+// ESP8266: a single producer on the one core.
+static inline uint32_t benchStamp() { return ESP.getCycleCount(); }
+static inline uint32_t benchNs(uint32_t from, uint32_t to) {
+    return (uint32_t)((uint64_t)(to - from) * 1000 / ESP.getCpuFreqMHz());
+}
+static inline uint64_t benchWallNs() { return micros64() * 1000; }
+#else
+static inline uint64_t benchStamp() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static inline uint32_t benchNs(uint64_t from, uint64_t to) {
+    uint64_t d = to - from;
+    return d > 0xffffffffu ? 0xffffffffu : (uint32_t)d;
+}
+static inline uint64_t benchWallNs() { return benchStamp(); }
+#endif
+
+// ---- latency histogram ------------------------------------------------------
+
+// Log-linear: 8 sub-buckets per power of two, ~12% resolution.
+static const int kSubBits = 3;
+static const int kBuckets = 32 << kSubBits;
+
+static int bucketOf(uint32_t ns) {
+    if (ns < (1u << kSubBits)) return (int)ns;
+    int msb = 31 - __builtin_clz(ns);
+    int sub = (ns >> (msb - kSubBits)) & ((1 << kSubBits) - 1);
+    return ((msb - kSubBits + 1) << kSubBits) | sub;
+}
+
+static uint32_t bucketFloor(int b) {
+    if (b < (1 << kSubBits)) return (uint32_t)b;
+    int msb = (b >> kSubBits) + kSubBits - 1;
+    uint32_t sub = b & ((1 << kSubBits) - 1);
+    return (1u << msb) | (sub << (msb - kSubBits));
+}
+
+struct Producer {
+    LoggingBase* logger;
+    LogBenchCall call;
+    uint32_t iterations;
+    uint32_t maxNs;
+    uint32_t histogram[kBuckets];
+#if defined(ESP32)
+    SemaphoreHandle_t done;
+#endif
+};
+
+static void runProducer(Producer& p) {
+    benchCountAllocations(true);
+    for (uint32_t i = 0; i < p.iterations; ++i) {
+        auto t0 = benchStamp();
+        p.call(*p.logger, i);
+        auto t1 = benchStamp();
+        uint32_t ns = benchNs(t0, t1);
+        p.histogram[bucketOf(ns)]++;
+        if (ns > p.maxNs) p.maxNs = ns;
+    }
+    benchCountAllocations(false);
+}
+
+#if defined(ESP32)
+static void producerTask(void* arg) {
+    Producer* p = static_cast<Producer*>(arg);
+    runProducer(*p);
+    xSemaphoreGive(p->done);
+    vTaskDelete(nullptr);
+}
+#endif
+
+// ---- runner -----------------------------------------------------------------
+
+LogBenchResult runLogBenchmark(LoggingBase& logger, const char* backend,
+                               LogBenchCall call, const char* callName,
+                               uint32_t iterations, uint8_t producers) {
+    if (producers < 1) producers = 1;
+    if (producers > LOG_BENCH_MAX_PRODUCERS) producers = LOG_BENCH_MAX_PRODUCERS;
+#if defined(ARDUINO) && !defined(ESP32)
+    producers = 1;   // no tasks to run more on
+#endif
+
+    // Allocated outside the measured region.
+    std::unique_ptr<Producer[]> ps(new Producer[producers]());
+    for (uint8_t i = 0; i < producers; ++i) {
+        ps[i].logger = &logger;
+        ps[i].call = call;
+        ps[i].iterations = iterations / producers;
+    }
+    uint32_t calls = (iterations / producers) * producers;
+
+    uint32_t allocs0 = benchAllocations();
+    uint64_t wall0 = benchWallNs();
+#if defined(ESP32)
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(producers, 0);
+    for (uint8_t i = 0; i < producers; ++i) {
+        ps[i].done = done;
+        xTaskCreatePinnedToCore(producerTask, "logBench", 4096, &ps[i],
+                                uxTaskPriorityGet(nullptr), nullptr,
+                                i % portNUM_PROCESSORS);
+    }
+    for (uint8_t i = 0; i < producers; ++i) xSemaphoreTake(done, portMAX_DELAY);
+    vSemaphoreDelete(done);
+#elif !defined(ARDUINO)
+    std::unique_ptr<std::thread[]> threads(new std::thread[producers]);
+    for (uint8_t i = 0; i < producers; ++i) threads[i] = std::thread(runProducer, std::ref(ps[i]));
+    for (uint8_t i = 0; i < producers; ++i) threads[i].join();
+#else
+    runProducer(ps[0]);
+#endif
+    uint64_t wallNs = benchWallNs() - wall0;
+    uint32_t allocs = benchAllocations() - allocs0;
+
+    // Merge histograms and read off the percentiles.
+    uint32_t merged[kBuckets] = {0};
+    uint32_t maxNs = 0;
+    for (uint8_t i = 0; i < producers; ++i) {
+        for (int b = 0; b < kBuckets; ++b) merged[b] += ps[i].histogram[b];
+        if (ps[i].maxNs > maxNs) maxNs = ps[i].maxNs;
+    }
+    uint32_t p50 = 0, p99 = 0, seen = 0;
+    bool have50 = false;
+    for (int b = 0; b < kBuckets; ++b) {
+        seen += merged[b];
+        if (!have50 && (uint64_t)seen * 100 >= (uint64_t)calls * 50) {
+            p50 = bucketFloor(b);
+            have50 = true;
+        }
+        if ((uint64_t)seen * 100 >= (uint64_t)calls * 99) {
+            p99 = bucketFloor(b);
+            break;
+        }
+    }
+
+    LogBenchResult r;
+    r.backend = backend;
+    r.call = callName;
+    r.producers = producers;
+    r.calls = calls;
+    r.nsPerCall = calls ? (double)wallNs / calls : 0;
+    r.callsPerSec = wallNs ? calls * 1e9 / (double)wallNs : 0;
+    r.allocsPerCall = calls ? (double)allocs / calls : 0;
+    r.p50Ns = p50;
+    r.p99Ns = p99;
+    r.maxNs = maxNs;
+    return r;
+}
+
+void printLogBenchResult(const LogBenchResult& r, LoggingBase& out) {
+    // Longer than LOGGING_LINE_BUFFER_SIZE, so format into a local buffer.
+    char buf[320];
+    LogFormatter f(buf, sizeof(buf));
+    f.appendf("{\"bench\":\"log\",\"backend\":\"%s\",\"call\":\"%s\",\"producers\":%u,"
+              "\"calls\":%u,\"ns_per_call\":%.1f,\"calls_per_sec\":%.0f,"
+              "\"" LOG_BENCH_ALLOCS_KEY "\":%.3f,\"p50_ns\":%u,\"p99_ns\":%u,\"max_ns\":%u}",
+              r.backend, r.call, (unsigned)r.producers, (unsigned)r.calls, r.nsPerCall,
+              r.callsPerSec, r.allocsPerCall, (unsigned)r.p50Ns, (unsigned)r.p99Ns,
+              (unsigned)r.maxNs);
+    out.writeln(f.data(), f.length());
+}
+
+void runHexdumpBenchmark(LoggingBase& logger, const char* backend, LoggingBase& out,
+                         uint8_t flags, size_t bytes, uint32_t repeats) {
+    std::unique_ptr<uint8_t[]> payload(new uint8_t[bytes]);
+    for (size_t i = 0; i < bytes; ++i) payload[i] = (uint8_t)(i * 31 + 7);
+
+    uint32_t allocs0 = benchAllocations();
+    uint64_t wall0 = benchWallNs();
+    benchCountAllocations(true);
+    for (uint32_t r = 0; r < repeats; ++r) logger.hexdump(payload.get(), bytes, flags);
+    benchCountAllocations(false);
+    uint64_t wallNs = benchWallNs() - wall0;
+    uint32_t allocs = benchAllocations() - allocs0;
+
+    double total = (double)bytes * repeats;
+    out.printfln("{\"bench\":\"hexdump\",\"backend\":\"%s\",\"flags\":%u,\"bytes\":%u,"
+                 "\"mb_per_sec\":%.2f,\"allocs\":%u}",
+                 backend, (unsigned)flags, (unsigned)bytes,
+                 wallNs ? total * 1000.0 / (double)wallNs : 0.0, (unsigned)allocs);
+}
+
+// Counts what would reach the real sink.
+class CountingSink : public LoggingBase {
+public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+    void print(const String& msg) override { bytes += msg.length(); }
+    void println(const String& msg) override { bytes += msg.length() + 1; }
+    void write(const char* data, size_t len) override { bytes += len; }
+    void writeln(const char* data, size_t len) override { bytes += len + 1; }
+    size_t bytes = 0;
+};
+
+void runCompressionBenchmark(LoggingBase& out, const char* corpus, size_t bytes) {
+    static const char* const kTags[] = { "wifi", "mqtt", "sensor", "ota" };
+    static const char* const kLevels[] = { "E", "W", "I", "D" };
+    bool mixed = strcmp(corpus, "mixed") == 0;
+
+    CountingSink sink;
+    std::unique_ptr<CompressedLogging> packed(new CompressedLogging(sink));
+    uint32_t seed = 12345;
+    uint32_t ms = 0;
+    while (packed->bytesIn() < bytes) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t r = seed >> 8;
+        ms += 7 + r % 250;
+        unsigned s = ms / 1000;
+        if (mixed && r % 8 == 0) {
+            uint8_t frame[24];
+            for (size_t i = 0; i < sizeof(frame); ++i) frame[i] = (uint8_t)(r >> (i & 15)) ^ (uint8_t)i;
+            packed->hexdump(frame, sizeof(frame), LogHexOffset | LogHexAscii);
+        } else if (mixed && r % 8 == 1) {
+            packed->printfln("%02u:%02u:%02u.%03u I ota: event=chunk offset=%u len=512 crc=%08x",
+                             s / 3600 % 24, s / 60 % 60, s % 60, ms % 1000,
+                             (unsigned)(r % 4096) * 512, (unsigned)seed);
+        } else {
+            packed->printfln("%02u:%02u:%02u.%03u %s %s: channel %u value=%d.%02u rssi=%d",
+                             s / 3600 % 24, s / 60 % 60, s % 60, ms % 1000,
+                             kLevels[r % 4], kTags[(r >> 2) % 4], (unsigned)(r >> 4) % 8,
+                             (int)(r >> 7) % 400 - 100, (unsigned)(r >> 3) % 100,
+                             -40 - (int)((r >> 11) % 50));
+        }
+    }
+    packed->flush();
+
+    double kb = packed->bytesIn() / 1024.0;
+    out.printfln("{\"bench\":\"compress\",\"corpus\":\"%s\",\"bytes_in\":%u,"
+                 "\"bytes_out\":%u,\"ratio\":%.2f,\"us_per_kb\":%.1f}",
+                 corpus, (unsigned)packed->bytesIn(), (unsigned)packed->bytesOut(),
+                 packed->bytesOut() ? (double)packed->bytesIn() / packed->bytesOut() : 0.0,
+                 kb > 0 ? packed->compressMicros() / kb : 0.0);
+}
+
+// getFormattedTime() as a typical String-based provider writes it, with the
+// same ISO-8601 output as formatTime(); the providers in this library return
+// formatTime() wrapped in a String or no date at all.
+class IsoStringTime : public TimeProviderBase {
+public:
+    explicit IsoStringTime(TimeProviderBase& inner) : inner_(inner) {}
+    void begin() override {}
+    uint32_t getUnixTime() override { return inner_.getUnixTime(); }
+    uint32_t getUnixUTCTime(uint32_t localTime = 0) override { return inner_.getUnixUTCTime(localTime); }
+    int getSecondsOfDay() override { return inner_.getSecondsOfDay(); }
+
+    String getFormattedTime() override {
+        uint32_t t = getUnixTime();
+        uint32_t sod = t % 86400;
+        uint16_t year;
+        uint8_t month, day;
+        civilFromDays(t / 86400, year, month, day);
+        String s((unsigned)year);
+        s += month < 10 ? "-0" : "-";
+        s += (unsigned)month;
+        s += day < 10 ? "-0" : "-";
+        s += (unsigned)day;
+        s += sod / 3600 < 10 ? "T0" : "T";
+        s += (unsigned)(sod / 3600);
+        s += sod / 60 % 60 < 10 ? ":0" : ":";
+        s += (unsigned)(sod / 60 % 60);
+        s += sod % 60 < 10 ? ":0" : ":";
+        s += (unsigned)(sod % 60);
+        return s;
+    }
+
+private:
+    TimeProviderBase& inner_;
+};
+
+void runTimeFormatBenchmark(LoggingBase& out, TimeProviderBase& time, uint32_t iterations) {
+    IsoStringTime iso(time);
+    volatile size_t sink = 0;   // keeps the results alive
+
+    uint64_t t0 = benchWallNs();
+    for (uint32_t i = 0; i < iterations; ++i) sink = sink + iso.getFormattedTime().length();
+    uint64_t stringNs = benchWallNs() - t0;
+
+    char buf[32];
+    t0 = benchWallNs();
+    for (uint32_t i = 0; i < iterations; ++i) sink = sink + iso.formatTime(buf, sizeof(buf));
+    uint64_t bufferNs = benchWallNs() - t0;
+
+    // Both paths must produce the same text for the comparison to hold.
+    iso.formatTime(buf, sizeof(buf));
+    bool same = iso.getFormattedTime() == String(buf);
+
+    out.printfln("{\"bench\":\"time_format\",\"call\":\"getFormattedTime\",\"calls\":%u,"
+                 "\"ns_per_call\":%.1f}", (unsigned)iterations, (double)stringNs / iterations);
+    out.printfln("{\"bench\":\"time_format\",\"call\":\"formatTime\",\"calls\":%u,"
+                 "\"ns_per_call\":%.1f,\"same_output\":%s}", (unsigned)iterations,
+                 (double)bufferNs / iterations, same ? "true" : "false");
+}
+
+// ---- line contention --------------------------------------------------------
+
+// Lock held by the sink per call and by "global_mutex" per line.
+class BenchLock {
+public:
+#if defined(ESP32)
+    BenchLock() : mutex_(xSemaphoreCreateMutex()) {}
+    ~BenchLock() { vSemaphoreDelete(mutex_); }
+    void lock() { xSemaphoreTake(mutex_, portMAX_DELAY); }
+    void unlock() { xSemaphoreGive(mutex_); }
+
+private:
+    SemaphoreHandle_t mutex_;
+#elif !defined(ARDUINO)
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    std::mutex mutex_;
+#else
+    // Single producer: nothing to exclude.
+    void lock() {}
+    void unlock() {}
+#endif
+};
+
+// Stands in for a UART driver: every call is written in one piece under the
+// driver's lock. Counts lines whose pieces came from more than one producer.
+class LockedSink : public LoggingBase {
+public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override { put(data, len, false); }
+    void writeln(const char* data, size_t len) override { put(data, len, true); }
+
+    uint32_t lines = 0;
+    uint32_t torn = 0;
+
+private:
+    void put(const char* data, size_t len, bool newline) {
+        lock_.lock();
+        for (size_t i = 0; i < len; ++i) buf_[(pos_ + i) % sizeof(buf_)] = data[i];
+        pos_ += len;
+        // Each piece starts with the producer's id.
+        char id = len ? data[0] : owner_;
+        if (owner_ && id != owner_) ++torn;
+        owner_ = newline ? 0 : id;
+        if (newline) ++lines;
+        lock_.unlock();
+    }
+
+    BenchLock lock_;
+    char buf_[256];
+    size_t pos_ = 0;
+    char owner_ = 0;
+};
+
+#if defined(ESP32) || !defined(ARDUINO)
+static std::atomic<int> _nextProducer{0};
+static char producerId() {
+    static thread_local char id = char('A' + _nextProducer.fetch_add(1) % 26);
+    return id;
+}
+#else
+static char producerId() { return 'A'; }
+#endif
+
+// One line in three pieces, as print() + print() + println() would give.
+static void threePieces(LoggingBase& l, uint32_t i) {
+    char a[24], b[24], c[24];
+    char id = producerId();
+    int na = snprintf(a, sizeof(a), "%c sensor %u", id, (unsigned)(i & 7));
+    int nb = snprintf(b, sizeof(b), "%c value=%u", id, (unsigned)i);
+    int nc = snprintf(c, sizeof(c), "%c ok", id);
+    l.write(a, na);
+    l.write(b, nb);
+    l.writeln(c, nc);
+}
+
+static BenchLock* _lineLock = nullptr;
+static void threePiecesLocked(LoggingBase& l, uint32_t i) {
+    _lineLock->lock();
+    threePieces(l, i);
+    _lineLock->unlock();
+}
+
+void runLineContentionBenchmark(LoggingBase& out, uint32_t iterations, uint8_t maxProducers) {
+    std::unique_ptr<BenchLock> lineLock(new BenchLock());
+    _lineLock = lineLock.get();
+    for (uint8_t producers = 1; producers <= maxProducers; ++producers) {
+        struct { const char* name; bool buffered; LogBenchCall call; } cases[] = {
+            { "direct",         false, threePieces },
+            { "global_mutex",   false, threePiecesLocked },
+            { "line_buffered",  true,  threePieces },
+        };
+        for (const auto& c : cases) {
+            std::unique_ptr<LockedSink> sink(new LockedSink());
+            std::unique_ptr<LineBufferedLogging> buffered(new LineBufferedLogging(*sink));
+            LoggingBase& logger = c.buffered ? (LoggingBase&)*buffered : (LoggingBase&)*sink;
+            LogBenchResult r = runLogBenchmark(logger, c.name, c.call, "three_pieces",
+                                               iterations, producers);
+            out.printfln("{\"bench\":\"line_contention\",\"backend\":\"%s\",\"producers\":%u,"
+                         "\"lines\":%u,\"ns_per_line\":%.1f,\"p50_ns\":%u,\"p99_ns\":%u,"
+                         "\"max_ns\":%u,\"torn_lines\":%u,\"fallbacks\":%u}",
+                         c.name, (unsigned)producers, (unsigned)sink->lines, r.nsPerCall,
+                         (unsigned)r.p50Ns, (unsigned)r.p99Ns, (unsigned)r.maxNs,
+                         (unsigned)sink->torn, (unsigned)buffered->fallbacks());
+        }
+    }
+    _lineLock = nullptr;
+}
+
+// ---- standard call set ------------------------------------------------------
+
+static void benchPrintln(LoggingBase& l, uint32_t)    { l.println("sensor 3 reading ok"); }
+static void benchPrintInt(LoggingBase& l, uint32_t i) { l.println(i); }
+static void benchPrintfln(LoggingBase& l, uint32_t i) { l.printfln("sensor %u value=%d", i & 7, (int)i); }
+static void benchLogf(LoggingBase& l, uint32_t i)     { l.logf(LogLevel::Info, "sensor %u value=%d", i & 7, (int)i); }
+static void benchLogLine(LoggingBase& l, uint32_t i)  { LogLine(l) << "sensor " << (i & 7) << " value=" << i; }
+static void benchString(LoggingBase& l, uint32_t i)   { l.println(String("sensor value=") + String(i)); }
+
+void runStandardLogBenchmarks(LoggingBase& logger, const char* backend, LoggingBase& out,
+                              uint32_t iterations, uint8_t maxProducers) {
+    static const struct { const char* name; LogBenchCall call; } calls[] = {
+        { "println_cstr", benchPrintln },
+        { "println_int",  benchPrintInt },
+        { "printfln",     benchPrintfln },
+        { "logf",         benchLogf },
+        { "LogLine",      benchLogLine },
+        { "println_String", benchString },
+    };
+    for (uint8_t producers = 1; producers <= maxProducers; ++producers) {
+        for (const auto& c : calls) {
+            printLogBenchResult(runLogBenchmark(logger, backend, c.call, c.name, iterations, producers), out);
+        }
+    }
+}
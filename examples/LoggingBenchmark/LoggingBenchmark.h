@@ -0,0 +1,89 @@
+#ifndef LOGGING_BENCHMARK_H
+#define LOGGING_BENCHMARK_H
+
+#include <LoggingBase.h>
+#include <TimeProviderBase.h>
+
+#ifndef LOG_BENCH_MAX_PRODUCERS
+  #define LOG_BENCH_MAX_PRODUCERS 8
+#endif
+
+/**
+ * Throughput and latency benchmark for logging backends.
+ *
+ * Runs a logging call `iterations` times, split over 1..N concurrent
+ * producers (FreeRTOS tasks on the ESP32, std::thread on a host against the
+ * shim in test/host: make -C test/host bench; the ESP8266 runs a single
+ * producer), and reports one JSON object per run, e.g.
+ *
+ *   {"bench":"log","backend":"null","call":"printfln","producers":2,
+ *    "calls":20000,"ns_per_call":812.4,"calls_per_sec":2461538,
+ *    "allocs_per_call":0.000,"p50_ns":768,"p99_ns":1536,"max_ns":9984}
+ *
+ * Latencies come from a log-linear histogram (8 buckets per power of two).
+ * On a host, allocs_per_call counts every operator new made by the
+ * producers (global operator new is replaced in this file). The ESP32 heap
+ * has no cheap per-call counter, so there the field is
+ * adapter_allocs_per_call: only the String copies made by the
+ * LoggingBase::write()/writeln() adapters (LoggingBase::adapterAllocations()).
+ *
+ *   static NullLogging nullBackend;
+ *   runStandardLogBenchmarks(nullBackend, "null", serialOut);
+ */
+
+struct LogBenchResult {
+    const char* backend;
+    const char* call;
+    uint8_t producers;
+    uint32_t calls;
+    double nsPerCall;      // wall time / calls, all producers together
+    double callsPerSec;
+    double allocsPerCall;  // see above: all allocations on a host, adapters on the device
+    uint32_t p50Ns;
+    uint32_t p99Ns;
+    uint32_t maxNs;
+};
+
+// The measured operation; `i` is the iteration number within the producer.
+typedef void (*LogBenchCall)(LoggingBase& logger, uint32_t i);
+
+LogBenchResult runLogBenchmark(LoggingBase& logger, const char* backend,
+                               LogBenchCall call, const char* callName,
+                               uint32_t iterations, uint8_t producers = 1);
+
+// Writes `r` as a single JSON line.
+void printLogBenchResult(const LogBenchResult& r, LoggingBase& out);
+
+// Measures hexdump() throughput over a `bytes` payload and prints one JSON
+// line {"bench":"hexdump",...,"mb_per_sec":...,"allocs":...} (allocations
+// counted as for allocs_per_call).
+void runHexdumpBenchmark(LoggingBase& logger, const char* backend, LoggingBase& out,
+                         uint8_t flags = LogHexPlain, size_t bytes = 4096, uint32_t repeats = 50);
+
+// Feeds a representative log corpus of about `bytes` through a
+// CompressedLogging stage and prints one JSON line with the compression
+// ratio and CPU cost per KB of input ("sensor" lines, or "mixed" with hex
+// dumps and structured records).
+void runCompressionBenchmark(LoggingBase& out, const char* corpus = "sensor",
+                             size_t bytes = 64 * 1024);
+
+// Compares building the ISO-8601 time of `time` as a String, the usual
+// getFormattedTime() way, against formatTime() into a stack buffer; prints
+// one JSON line per path with ns_per_call (and whether the texts match).
+void runTimeFormatBenchmark(LoggingBase& out, TimeProviderBase& time = *gTimeProvider,
+                            uint32_t iterations = 100000);
+
+// Writes lines in three pieces (print + print + println) from 1..maxProducers
+// producers to a sink that locks around every call, like a UART driver, and
+// compares no coordination ("direct"), one mutex held per line
+// ("global_mutex") and LineBufferedLogging ("line_buffered"). One JSON line
+// per case with latencies and the number of torn (interleaved) lines.
+void runLineContentionBenchmark(LoggingBase& out, uint32_t iterations = 10000,
+                                uint8_t maxProducers = 2);
+
+// Runs the built-in call set for 1, 2, ... maxProducers producers and
+// prints every result to `out`.
+void runStandardLogBenchmarks(LoggingBase& logger, const char* backend, LoggingBase& out,
+                              uint32_t iterations = 10000, uint8_t maxProducers = 2);
+
+#endif
@@ -0,0 +1,46 @@
+// Logging benchmark for the ESP32 (and, single producer, the ESP8266):
+// prints one JSON line per measurement to Serial. The same runner builds on
+// a host: make -C test/host bench
+
+#include <LoggingBase.h>
+#include <AsyncLogging.h>
+#include <RateLimitedLogging.h>
+#include <TeeLogging.h>
+#include "LoggingBenchmark.h"
+
+static NullLogging nullBackend;
+static NullLogging nullBackend2;
+static SerialLogging serialOut;
+static TeeLogging tee;
+static RateLimitedLogging dedup(nullBackend);
+#if defined(ESP32)
+static AsyncLogging async(nullBackend);
+#endif
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    tee.addSink(nullBackend, LogLevel::Info);
+    tee.addSink(nullBackend2, LogLevel::Warn);
+
+    runStandardLogBenchmarks(nullBackend, "null", serialOut, 10000, 2);
+    // The measured lines themselves go to the UART here, so keep it short.
+    runStandardLogBenchmarks(serialOut, "serial", serialOut, 1000, 1);
+#if defined(ESP32)
+    async.begin();
+    runStandardLogBenchmarks(async, "async", serialOut, 10000, 2);
+    async.end();
+#endif
+    runStandardLogBenchmarks(tee, "tee", serialOut, 10000, 2);
+    runStandardLogBenchmarks(dedup, "rate_limited", serialOut, 10000, 2);
+    runHexdumpBenchmark(nullBackend, "null", serialOut);
+    runCompressionBenchmark(serialOut, "sensor");
+    runCompressionBenchmark(serialOut, "mixed");
+    runTimeFormatBenchmark(serialOut);
+    runLineContentionBenchmark(serialOut, 10000, 2);
+}
+
+void loop() {
+    delay(1000);
+}
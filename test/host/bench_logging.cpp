@@ -0,0 +1,63 @@
+// Host run of examples/LoggingBenchmark: make bench
+
+#include <LoggingBenchmark.h>
+#include <AsyncLogging.h>
+#include <RateLimitedLogging.h>
+#include <TeeLogging.h>
+#include <atomic>
+#include <thread>
+
+HardwareSerial Serial;
+
+// Results go straight to stdout; Serial, which SerialLogging is measured
+// against, writes to /dev/null.
+class StdoutLogging : public LoggingBase {
+public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override { fwrite(data, 1, len, stdout); }
+    void writeln(const char* data, size_t len) override {
+        fwrite(data, 1, len, stdout);
+        fputc('\n', stdout);
+    }
+};
+
+int main() {
+    StdoutLogging out;
+    Serial.stream = fopen("/dev/null", "w");
+
+    NullLogging nullBackend;
+    NullLogging nullBackend2;
+    SerialLogging serial;
+    TeeLogging tee;
+    tee.addSink(nullBackend, LogLevel::Info);
+    tee.addSink(nullBackend2, LogLevel::Warn);
+    RateLimitedLogging dedup(nullBackend);
+    AsyncLogging async(nullBackend);
+
+    // Stands in for the drain task.
+    std::atomic<bool> stop{false};
+    std::thread drainer([&] {
+        while (!stop) {
+            if (!async.drain()) std::this_thread::yield();
+        }
+    });
+
+    runStandardLogBenchmarks(nullBackend, "null", out, 100000, 4);
+    runStandardLogBenchmarks(serial, "serial", out, 100000, 4);
+    runStandardLogBenchmarks(async, "async", out, 100000, 4);
+    runStandardLogBenchmarks(tee, "tee", out, 100000, 4);
+    runStandardLogBenchmarks(dedup, "rate_limited", out, 100000, 4);
+    stop = true;
+    drainer.join();
+
+    runHexdumpBenchmark(nullBackend, "null", out);
+    runCompressionBenchmark(out, "sensor");
+    runCompressionBenchmark(out, "mixed");
+    runTimeFormatBenchmark(out);
+    runLineContentionBenchmark(out, 200000, 4);
+    return 0;
+}
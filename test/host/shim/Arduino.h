@@ -0,0 +1,74 @@
+#ifndef HOST_ARDUINO_SHIM_H
+#define HOST_ARDUINO_SHIM_H
+
+// Just enough of the Arduino core to build the library on a POSIX host for
+// the tests in test/host. Not a general replacement.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#define IRAM_ATTR
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+#define strlen_P strlen
+#define memcpy_P memcpy
+
+class String {
+public:
+    String() {}
+    String(const char* s) : s_(s ? s : "") {}
+    String(const __FlashStringHelper* s) : s_(reinterpret_cast<const char*>(s)) {}
+    String(char c) : s_(1, c) {}
+    String(int v) : s_(std::to_string(v)) {}
+    String(unsigned int v) : s_(std::to_string(v)) {}
+    String(long v) : s_(std::to_string(v)) {}
+    String(unsigned long v) : s_(std::to_string(v)) {}
+    String(double v, unsigned char decimals = 2) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        s_ = buf;
+    }
+
+    const char* c_str() const { return s_.c_str(); }
+    size_t length() const { return s_.size(); }
+    void reserve(size_t n) { s_.reserve(n); }
+    bool concat(const char* data, size_t n) { s_.append(data, n); return true; }
+    String& operator+=(const String& o) { s_ += o.s_; return *this; }
+    String operator+(const String& o) const { String r(*this); r.s_ += o.s_; return r; }
+    bool operator==(const String& o) const { return s_ == o.s_; }
+
+private:
+    std::string s_;
+};
+
+// Serial goes to stdout; each test defines the instance.
+class HardwareSerial {
+public:
+    size_t write(const char* data, size_t len) { return fwrite(data, 1, len, stream); }
+    size_t write(const uint8_t* data, size_t len) { return fwrite(data, 1, len, stream); }
+    size_t print(const char* s) { return fputs(s, stream); }
+    size_t println() { return fwrite("\r\n", 1, 2, stream); }
+    size_t println(const char* s) { return print(s) + println(); }
+
+    FILE* stream = stdout;   // host only: where the "UART" output goes
+};
+extern HardwareSerial Serial;
+
+inline unsigned long millis() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+inline unsigned long micros() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+#endif
@@ -0,0 +1,62 @@
+// DriftCompensator fit on synthetic sync samples with a known frequency error.
+
+#include "testing.h"
+#include <DriftCompensator.h>
+#include <math.h>
+
+// Deterministic noise in [-amp, amp].
+static int64_t noise(uint32_t& seed, int64_t amp) {
+    seed = seed * 1103515245u + 12345u;
+    return (int64_t)((seed >> 8) % (uint32_t)(2 * amp + 1)) - amp;
+}
+
+// Offsets of a clock running `ppm` fast, sampled every `periodS`.
+static void feed(DriftCompensator& d, double ppm, uint64_t& mono, int64_t base,
+                 int count, uint32_t periodS, int64_t noiseUs, uint32_t& seed) {
+    for (int i = 0; i < count; ++i) {
+        mono += (uint64_t)periodS * 1000000;
+        int64_t offset = base - (int64_t)((double)mono * ppm / 1e6) + noise(seed, noiseUs);
+        d.addSample(mono, offset);
+    }
+}
+
+int main() {
+    uint32_t seed = 1;
+    uint64_t mono = 0;
+
+    // Not locked until the samples span DRIFT_MIN_SPAN_S.
+    DriftCompensator d;
+    feed(d, 25.0, mono, 0, 2, 60, 0, seed);
+    CHECK(!d.locked() && d.ppb() == 0);
+
+    // A local clock 25 ppm fast needs -25 ppm; 64 s spacing, +-2 ms noise.
+    feed(d, 25.0, mono, 0, DRIFT_MAX_SAMPLES, 64, 2000, seed);
+    CHECK(d.locked());
+    CHECK(fabsf(d.ppm() + 25.0f) < 10.0f);
+
+    // Low noise over longer spacing pins it down.
+    DriftCompensator fine;
+    mono = 0;
+    feed(fine, -40.0, mono, 0, DRIFT_MAX_SAMPLES, 600, 200, seed);
+    uint64_t fineMono = mono;
+    CHECK(fine.locked());
+    CHECK(fabsf(fine.ppm() - 40.0f) < 0.2f);
+    CHECK(fine.correction(1000000000) > 39000 && fine.correction(1000000000) < 41000);
+
+    // Far outside crystal tolerance: clamped.
+    DriftCompensator wild;
+    mono = 0;
+    feed(wild, 700.0, mono, 0, DRIFT_MAX_SAMPLES, 60, 0, seed);
+    CHECK(wild.locked());
+    CHECK(wild.ppb() == -DRIFT_MAX_PPM * 1000);
+
+    // A reference step beyond DRIFT_RESTART_MS starts over from that sample.
+    mono = fineMono + 600000000;
+    int64_t stepped = (int64_t)((double)mono * 40.0 / 1e6) + 5000000;
+    CHECK(!fine.addSample(mono, stepped));
+    CHECK(!fine.locked() && fine.samples() == 1 && fine.ppb() == 0);
+    // A sample that fits (and is later in time) is accepted.
+    CHECK(fine.addSample(mono + 60000000, stepped + 2400));   // 40 ppm of 60 s
+    CHECK(fine.samples() == 2);
+    return testFailures;
+}
@@ -0,0 +1,142 @@
+// FlashRingLogging on plain files: wrap-around, reattach after a restart,
+// and that segments are only ever appended to.
+
+#include "testing.h"
+#include <FlashRingLogging.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+class Lines : public LoggingBase {
+public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override { partial.append(data, len); }
+    void writeln(const char* data, size_t len) override {
+        lines.push_back(partial + std::string(data, len));
+        partial.clear();
+    }
+
+    std::vector<std::string> lines;
+    std::string partial;
+};
+
+static std::string readFile(const std::string& name) {
+    std::string s;
+    FILE* f = fopen(name.c_str(), "rb");
+    if (!f) return s;
+    char buf[512];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) s.append(buf, n);
+    fclose(f);
+    return s;
+}
+
+static void logLines(FlashRingLogging& ring, int from, int to) {
+    char line[64];
+    for (int i = from; i < to; ++i) {
+        int n = snprintf(line, sizeof(line), "line %05d some payload", i);
+        ring.writeln(line, n);
+    }
+}
+
+// The dump must be the newest lines, consecutive and ending at `last`.
+static void checkTail(FlashRingLogging& ring, int last, size_t minLines) {
+    Lines out;
+    ring.dump(out);
+    CHECK(out.lines.size() >= minLines);
+    int expect = last - (int)out.lines.size() + 1;
+    for (const std::string& l : out.lines) {
+        char want[64];
+        snprintf(want, sizeof(want), "line %05d some payload", expect++);
+        CHECK(l == want);
+    }
+}
+
+int main() {
+    char dir[] = "/tmp/flashringXXXXXX";
+    CHECK(mkdtemp(dir) != nullptr);
+    std::string path = std::string(dir) + "/log";
+    const uint32_t capacity = 4096;
+    const size_t lineLen = 26;   // "line 00000 some payload\n"
+
+    {
+        FlashRingLogging tooSmall(path.c_str(), FLASH_LOG_SEGMENTS - 1);
+        CHECK(!tooSmall.begin());
+    }
+
+    {
+        FlashRingLogging ring(path.c_str(), capacity);
+        CHECK(ring.begin());
+        logLines(ring, 0, 20);
+        ring.flush();
+        checkTail(ring, 19, 20);
+
+        // Append only: what is in the segment stays its prefix.
+        std::string before = readFile(path + ".0");
+        logLines(ring, 20, 30);
+        ring.flush();
+        std::string after = readFile(path + ".0");
+        CHECK(after.size() > before.size());
+        CHECK(after.compare(0, before.size(), before) == 0);
+
+        // Several times around the ring.
+        logLines(ring, 30, 1000);
+        ring.flush();
+        CHECK(ring.size() <= capacity);
+        CHECK(ring.size() > capacity - capacity / FLASH_LOG_SEGMENTS);
+        checkTail(ring, 999, (capacity - capacity / FLASH_LOG_SEGMENTS) / lineLen - 1);
+
+        // Logging into the ring while dumping it is dropped, not a deadlock.
+        ring.dump(ring);
+        checkTail(ring, 999, 100);
+        ring.println("unflushed");
+        Lines out;
+        ring.dump(out);
+        CHECK(!out.lines.empty() && out.lines.back() == "unflushed");
+    }
+
+    {
+        // Restart: the ring is found again and continues after its head.
+        FlashRingLogging ring(path.c_str(), capacity);
+        CHECK(ring.begin());
+        Lines out;
+        ring.dump(out);
+        CHECK(!out.lines.empty() && out.lines.back() == "unflushed");
+        logLines(ring, 2000, 2010);
+        ring.end();
+        CHECK(ring.begin());
+        Lines again;
+        ring.dump(again);
+        CHECK(again.lines.size() == out.lines.size() + 10);
+        CHECK(again.lines[out.lines.size() - 1] == "unflushed");
+        CHECK(again.lines.back() == "line 02009 some payload");
+        ring.end();
+
+        // Segments written with another capacity are not reused.
+        {
+            FlashRingLogging other(path.c_str(), capacity * 2);
+            CHECK(other.begin());
+            CHECK(other.size() == 0);
+            Lines none;
+            other.dump(none);
+            CHECK(none.lines.empty());
+        }
+
+        CHECK(ring.begin());
+        logLines(ring, 3000, 3005);
+        ring.clear();
+        CHECK(ring.size() == 0);
+        Lines empty;
+        ring.dump(empty);
+        CHECK(empty.lines.empty());
+    }
+
+    for (int i = 0; i < FLASH_LOG_SEGMENTS; ++i) remove((path + "." + std::to_string(i)).c_str());
+    rmdir(dir);
+    return testFailures;
+}
@@ -0,0 +1,53 @@
+// setLogger() / synchronizeLogger() grace periods.
+
+#include "testing.h"
+#include <LoggingBase.h>
+#include <atomic>
+#include <thread>
+
+static void testWaitsForRegisteredReader() {
+    std::atomic<bool> inside{false}, leave{false}, done{false};
+    std::thread worker([&] {
+        LoggerReader reader;
+        CHECK(reader.registered());
+        LoggingBase* held = gLogger.get();   // stands for a call in flight
+        inside = true;
+        while (!leave) delay(1);
+        (void)held;
+        reader.quiescent();
+        while (!done) delay(1);
+    });
+    while (!inside) delay(1);
+
+    NullLogging replacement;
+    LoggingBase* old = setLogger(&replacement);
+    std::atomic<bool> synced{false};
+    std::thread syncer([&] { CHECK(synchronizeLogger()); synced = true; });
+    delay(50);
+    CHECK(!synced);
+    leave = true;
+    syncer.join();
+    CHECK(synced);
+
+    done = true;
+    worker.join();
+    setLogger(old);
+}
+
+static void testRefusesWithUntrackedReader() {
+    LoggerReader* readers[LOGGER_MAX_READERS + 1];
+    for (int i = 0; i < LOGGER_MAX_READERS + 1; ++i) readers[i] = new LoggerReader;
+    CHECK(!readers[LOGGER_MAX_READERS]->registered());
+    CHECK(!synchronizeLogger(readers[0]));
+
+    delete readers[LOGGER_MAX_READERS];
+    for (int i = 1; i < LOGGER_MAX_READERS; ++i) readers[i]->offline();
+    CHECK(synchronizeLogger(readers[0]));
+    for (int i = 0; i < LOGGER_MAX_READERS; ++i) delete readers[i];
+}
+
+int main() {
+    testWaitsForRegisteredReader();
+    testRefusesWithUntrackedReader();
+    return testFailures;
+}
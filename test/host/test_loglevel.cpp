@@ -0,0 +1,39 @@
+// Runtime log levels: the global threshold and per-module tags.
+
+#include "testing.h"
+#include <LogLevel.h>
+
+class NullOut : public LoggingBase {
+public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String&) override {}
+    void println(const String&) override {}
+    void write(const char*, size_t) override {}
+    void writeln(const char*, size_t) override {}
+};
+
+LOG_DEFINE_TAG(early);
+
+int main() {
+    NullOut out;
+    CHECK(getLogLevel() == (LogLevel)LOG_LEVEL);
+    CHECK(early.level() == (LogLevel)LOG_LEVEL);
+
+    // Tags created later start from the runtime threshold, not LOG_LEVEL.
+    setLogLevel(LogLevel::Trace);
+    CHECK(logLevelEnabled(LogLevel::Trace));
+    static LogTag late("late");
+    CHECK(late.level() == LogLevel::Trace);
+    CHECK(late.index() != early.index());
+
+    CHECK(logLevelCommand("late warn", out));
+    CHECK(late.level() == LogLevel::Warn && !late.enabled(LogLevel::Info));
+    CHECK(early.level() == (LogLevel)LOG_LEVEL);
+    CHECK(logLevelCommand("error", out));
+    CHECK(getLogLevel() == LogLevel::Error && !logLevelEnabled(LogLevel::Warn));
+    CHECK(!logLevelCommand("nosuchtag debug", out));
+    CHECK(findLogTag("early") == &early);
+    return testFailures;
+}
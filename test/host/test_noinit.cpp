@@ -0,0 +1,62 @@
+// NoInitLogging: the previous run's tail is replayed unmixed with new output.
+
+#include "testing.h"
+#include <NoInitLogging.h>
+#include <string>
+#include <vector>
+
+class Lines : public LoggingBase {
+public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override { partial.append(data, len); }
+    void writeln(const char* data, size_t len) override {
+        lines.push_back(partial + std::string(data, len));
+        partial.clear();
+    }
+
+    std::vector<std::string> lines;
+    std::string partial;
+};
+
+int main() {
+    Lines sink;
+    {
+        // First "run": fresh ring.
+        NoInitLogging crashLog(sink);
+        CHECK(!crashLog.begin());
+        crashLog.println("previous run line");
+    }
+
+    {
+        // Second "run" on the same memory. Output before replay() is
+        // forwarded but not mixed into the frozen ring.
+        NoInitLogging crashLog(sink);
+        CHECK(crashLog.begin());
+        crashLog.println("current run line");
+        CHECK(sink.lines.back() == "current run line");
+
+        // Replaying through the logger itself must not disturb the ring.
+        sink.lines.clear();
+        CHECK(crashLog.replay(crashLog) > 0);
+        CHECK(sink.lines.size() == 3);
+        CHECK(sink.lines[0] == "--- log before reset ---");
+        CHECK(sink.lines[1] == "previous run line");
+        CHECK(sink.lines[2] == "--- end of previous log ---");
+        CHECK(crashLog.replay(sink) == 0);
+
+        crashLog.println("after replay");
+    }
+
+    {
+        NoInitLogging crashLog(sink);
+        CHECK(crashLog.begin());
+        Lines out;
+        crashLog.replay(out);
+        CHECK(out.lines.size() == 3 && out.lines[1] == "after replay");
+    }
+    return testFailures;
+}
@@ -0,0 +1,131 @@
+// NtpTimeProvider against an SNTP responder thread on localhost.
+
+#include "testing.h"
+#include <NtpTimeProvider.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <time.h>
+#include <atomic>
+#include <thread>
+
+static const uint64_t kNtpToUnixSeconds = 2208988800ull;
+
+static int64_t realMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void putNtp(uint8_t* p, int64_t unixUs) {
+    uint64_t v = ((uint64_t)(unixUs / 1000000) + kNtpToUnixSeconds) << 32 |
+                 ((uint64_t)(unixUs % 1000000) << 32) / 1000000;
+    for (int i = 7; i >= 0; --i) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+// Answers every request with the host's real time plus `offsetUs`.
+class Responder {
+public:
+    Responder() {
+        fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(fd_, (const sockaddr*)&addr, sizeof(addr));
+        socklen_t len = sizeof(addr);
+        getsockname(fd_, (sockaddr*)&addr, &len);
+        port = ntohs(addr.sin_port);
+        timeval tv = { 0, 50000 };
+        setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~Responder() {
+        stop_ = true;
+        thread_.join();
+        close(fd_);
+    }
+
+    uint16_t port;
+    std::atomic<int64_t> offsetUs{0};
+
+private:
+    void run() {
+        while (!stop_) {
+            uint8_t pkt[48];
+            sockaddr_in from;
+            socklen_t len = sizeof(from);
+            ssize_t n = recvfrom(fd_, pkt, sizeof(pkt), 0, (sockaddr*)&from, &len);
+            if (n != (ssize_t)sizeof(pkt)) continue;
+            int64_t now = realMicros() + offsetUs.load();
+            memcpy(pkt + 24, pkt + 40, 8);   // origin = client transmit
+            pkt[0] = (4 << 3) | 4;           // version 4, mode 4 (server)
+            pkt[1] = 1;                      // stratum
+            putNtp(pkt + 32, now);
+            putNtp(pkt + 40, now);
+            sendto(fd_, pkt, sizeof(pkt), 0, (const sockaddr*)&from, len);
+        }
+    }
+
+    int fd_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+static int64_t absDiff(int64_t a, int64_t b) {
+    return a > b ? a - b : b - a;
+}
+
+int main() {
+    Responder server;
+    NtpTimeProvider ntp("127.0.0.1", server.port);
+    ntp.begin();
+
+    // First sync steps the clock from 1970 to the server's time.
+    CHECK(!ntp.synced());
+    CHECK(ntp.syncNow());
+    CHECK(ntp.stepCount() == 1);
+    CHECK(absDiff((int64_t)ntp.nowMicros(), realMicros()) < 5000);
+    CHECK(ntp.pollIntervalSeconds() == 1u << NTP_MIN_POLL_EXP);
+
+    // Offsets within the jitter gate lengthen the poll interval.
+    for (int i = 0; i < 8; ++i) CHECK(ntp.syncNow());
+    CHECK(ntp.stepCount() == 1);
+    CHECK(ntp.pollIntervalSeconds() > 1u << NTP_MIN_POLL_EXP);
+
+    // A small negative offset is slewed: the clock runs slow, never back.
+    server.offsetUs = -50000;
+    CHECK(ntp.syncNow());
+    CHECK(ntp.stepCount() == 1);
+    CHECK(absDiff(ntp.offsetMicros(), -50000) < 5000);
+    uint64_t m0 = TimeProviderBase::monotonicMicros();
+    uint64_t c0 = ntp.nowMicros();
+    uint64_t last = c0;
+    bool backwards = false;
+    while (TimeProviderBase::monotonicMicros() - m0 < 100000) {
+        uint64_t c = ntp.nowMicros();
+        backwards |= c < last;
+        last = c;
+    }
+    uint64_t c1 = ntp.nowMicros();
+    uint64_t m1 = TimeProviderBase::monotonicMicros();
+    CHECK(!backwards);
+    // 100 ms at NTP_MAX_SLEW_PPM is 50 us behind the monotonic timer.
+    CHECK(c1 - c0 + 20 < m1 - m0);
+    CHECK(c1 - c0 > (m1 - m0) - (m1 - m0) / 1000);
+
+    // A large offset is stepped and restarts the poll interval.
+    server.offsetUs = 10000000;
+    CHECK(ntp.syncNow());
+    CHECK(ntp.stepCount() == 2);
+    CHECK(absDiff((int64_t)ntp.nowMicros(), realMicros() + 10000000) < 5000);
+    CHECK(ntp.pollIntervalSeconds() == 1u << NTP_MIN_POLL_EXP);
+
+    ntp.end();
+    return testFailures;
+}
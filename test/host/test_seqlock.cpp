@@ -0,0 +1,94 @@
+// SeqLock consistency under concurrent publishers and readers, and the
+// CalendarCache built on it.
+
+#include "testing.h"
+#include <SeqLock.h>
+#include <TimeProviderBase.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Large enough that a torn copy is likely if the sequence check is wrong.
+struct Sample {
+    uint32_t words[32];
+    char tail[3];
+};
+
+static Sample makeSample(uint32_t k) {
+    Sample s;
+    memset(&s, 0, sizeof(s));   // padding too, for the memcmp below
+    for (uint32_t& w : s.words) w = k;
+    s.tail[0] = char(k);
+    s.tail[1] = char(k >> 8);
+    s.tail[2] = char(k >> 16);
+    return s;
+}
+
+static bool consistent(const Sample& s) {
+    Sample expected = makeSample(s.words[0]);
+    return memcmp(&expected, &s, sizeof(s)) == 0;
+}
+
+static void testConcurrentPublishers() {
+    SeqLock<Sample> lock;
+    Sample s;
+    CHECK(!lock.tryRead(s));
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> reads{0}, torn{0};
+    std::vector<std::thread> threads;
+    for (uint32_t w = 0; w < 2; ++w) {
+        threads.emplace_back([&, w] {
+            for (uint32_t k = w; !stop; k += 2) lock.tryPublish(makeSample(k));
+        });
+    }
+    for (int r = 0; r < 2; ++r) {
+        threads.emplace_back([&] {
+            Sample v;
+            while (!stop) {
+                if (!lock.tryRead(v)) continue;
+                reads.fetch_add(1, std::memory_order_relaxed);
+                if (!consistent(v)) torn.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    // Under load the readers may need a while to see an even sequence.
+    delay(200);
+    for (int i = 0; i < 200 && reads == 0; ++i) delay(10);
+    stop = true;
+    for (auto& t : threads) t.join();
+    CHECK(reads > 0);
+    CHECK(torn == 0);
+}
+
+static void testSingleWriter() {
+    SeqLock<Sample> lock(makeSample(7));
+    CHECK(lock.read().words[0] == 7);
+    lock.store(makeSample(8));
+    Sample s;
+    CHECK(lock.tryRead(s) && consistent(s) && s.words[31] == 8);
+}
+
+static bool sameTime(const CalendarTime& x, const CalendarTime& y) {
+    return x.year == y.year && x.month == y.month && x.day == y.day && x.hour == y.hour &&
+           x.minute == y.minute && x.second == y.second && x.secondOfDay == y.secondOfDay;
+}
+
+static void testCalendarCache() {
+    CalendarCache cache;
+    // Steps across a leap day and a year end, forward and back.
+    const uint32_t times[] = { 1709164790u, 1709164799u, 1709164800u, 1709251199u,
+                               1709251200u, 1735689590u, 1735689600u, 1709164800u,
+                               1735689600u + 100000u };
+    for (uint32_t t : times) CHECK(sameTime(cache.get(t), CalendarCache::compute(t)));
+    for (uint32_t t = 1735680000u; t < 1735700000u; t += 7) {
+        CHECK(sameTime(cache.get(t), CalendarCache::compute(t)));
+    }
+}
+
+int main() {
+    testConcurrentPublishers();
+    testSingleWriter();
+    testCalendarCache();
+    return testFailures;
+}
@@ -0,0 +1,116 @@
+// LogRecord CBOR encoding and its text rendering.
+
+#include "testing.h"
+#include <StructuredLogging.h>
+#include <string>
+#include <vector>
+
+// Keeps the binary record, or (textOnly) the line the default renders.
+class Capture : public LoggingBase {
+public:
+    explicit Capture(bool textOnly = false) : textOnly_(textOnly) {}
+
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override { text.append(data, len); }
+    void writeln(const char* data, size_t len) override { text.append(data, len); }
+    void log(LogLevel level, const char* data, size_t len) override {
+        lastLevel = level;
+        text.assign(data, len);
+    }
+    void logRecord(LogLevel level, const uint8_t* cbor, size_t len) override {
+        if (textOnly_) return LoggingBase::logRecord(level, cbor, len);
+        bytes.assign(cbor, cbor + len);
+    }
+
+    std::vector<uint8_t> bytes;
+    std::string text;
+    LogLevel lastLevel = LogLevel::None;
+
+private:
+    bool textOnly_;
+};
+
+static std::string render(const std::vector<uint8_t>& cbor, LogLevel* level = nullptr) {
+    char buf[256];
+    LogFormatter f(buf, sizeof(buf));
+    if (!renderLogRecord(cbor.data(), cbor.size(), f, level)) return "<invalid>";
+    return std::string(f.data(), f.length());
+}
+
+static void testEncoding() {
+    Capture out;
+    LogRecord(LogLevel::Warn, "ev", out)
+        .add("a", -1).add("b", true).add("c", false).add("n", 300u).add("m", -1000)
+        .add("s", "hi").emit();
+    const uint8_t expected[] = {
+        0x83, 0x02, 0x62, 'e', 'v', 0xbf,
+        0x61, 'a', 0x20,
+        0x61, 'b', 0xf5,
+        0x61, 'c', 0xf4,
+        0x61, 'n', 0x19, 0x01, 0x2c,
+        0x61, 'm', 0x39, 0x03, 0xe7,
+        0x61, 's', 0x62, 'h', 'i',
+        0xff,
+    };
+    CHECK(out.bytes == std::vector<uint8_t>(expected, expected + sizeof(expected)));
+
+    LogLevel level = LogLevel::None;
+    CHECK(render(out.bytes, &level) == "ev a=-1 b=true c=false n=300 m=-1000 s=\"hi\"");
+    CHECK(level == LogLevel::Warn);
+}
+
+static void testFloats() {
+    Capture out;
+    LogRecord(LogLevel::Info, "f", out).add("t", 21.5).add("z", 0.0).emit();
+    CHECK(render(out.bytes) == "f t=21.5 z=0");
+
+    // A float whose last byte is the CBOR "true" byte must stay a float.
+    float f;
+    uint32_t bits = 0x3f8000f5;
+    memcpy(&f, &bits, sizeof(f));
+    LogRecord(LogLevel::Info, "f", out).add("x", (double)f).emit();
+    CHECK(render(out.bytes) == "f x=1.00003");
+}
+
+static void testDefaultRendersText() {
+    Capture out(true);
+    LogRecord(LogLevel::Error, "reading", out).add("sensor", 3).add("ok", true).emit();
+    CHECK(out.text == "reading sensor=3 ok=true");
+    CHECK(out.lastLevel == LogLevel::Error);
+}
+
+static void testTruncation() {
+    Capture out;
+    LogRecord r(LogLevel::Info, "big", out);
+    std::string value(LOG_RECORD_BUFFER_SIZE, 'v');
+    r.add("first", 1).add("long", value.c_str()).add("after", 2);
+    CHECK(r.truncated());
+    r.emit();
+    CHECK(out.bytes.size() <= LOG_RECORD_BUFFER_SIZE);
+    CHECK(render(out.bytes) == "big first=1 after=2");
+}
+
+static void testFilteredLevel() {
+    Capture out;
+    LogRecord(LogLevel::Trace, "quiet", out).add("a", 1).emit();
+    CHECK(out.bytes.empty());
+}
+
+static void testRejectsGarbage() {
+    const uint8_t notRecord[] = { 0x82, 0x01, 0x60 };
+    CHECK(render(std::vector<uint8_t>(notRecord, notRecord + sizeof(notRecord))) == "<invalid>");
+}
+
+int main() {
+    testEncoding();
+    testFloats();
+    testDefaultRendersText();
+    testTruncation();
+    testFilteredLevel();
+    testRejectsGarbage();
+    return testFailures;
+}
@@ -0,0 +1,81 @@
+// SyslogLogging against a UDP listener on localhost.
+
+#include "testing.h"
+#include <SyslogLogging.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <string>
+
+static int openListener(uint16_t& port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    bind(fd, (const sockaddr*)&addr, sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd, (sockaddr*)&addr, &len);
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+// Returns the next datagram, or "" if none arrives within timeoutMs.
+static std::string receive(int fd, int timeoutMs = 200) {
+    timeval tv = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    char buf[2048];
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    return n > 0 ? std::string(buf, (size_t)n) : std::string();
+}
+
+static void testPendingMessagesAreSent(int fd, uint16_t port) {
+    SyslogLogging syslog("127.0.0.1", port, "node", "test");
+    CHECK(syslog.begin());
+    syslog.log(LogLevel::Warn, "hello", 5);
+    syslog.writeln("world", 5);
+
+#if SYSLOG_PACK_MESSAGES
+    syslog.update();
+    CHECK(receive(fd, 50).empty());
+
+    delay(SYSLOG_FLUSH_MS + 50);
+    syslog.update();
+    CHECK(receive(fd) == "<132>1 - node test - - - hello\n<134>1 - node test - - - world\n");
+#else
+    CHECK(receive(fd) == "<132>1 - node test - - - hello\n");
+    CHECK(receive(fd) == "<134>1 - node test - - - world\n");
+#endif
+    CHECK(receive(fd, 50).empty());
+}
+
+static void testFullDatagramsAndFlush(int fd, uint16_t port) {
+    SyslogLogging syslog("127.0.0.1", port, "node", "test");
+    CHECK(syslog.begin());
+    char line[100];
+    memset(line, 'x', sizeof(line));
+    const int lines = 50;
+    for (int i = 0; i < lines; ++i) syslog.log(LogLevel::Info, line, sizeof(line));
+    syslog.flush();
+
+    int messages = 0;
+    for (std::string d = receive(fd); !d.empty(); d = receive(fd, 50)) {
+        CHECK(d.size() <= SYSLOG_MAX_DATAGRAM);
+        CHECK(d.back() == '\n');
+        for (char c : d) messages += c == '\n';
+    }
+    CHECK(messages == lines);
+    CHECK(syslog.droppedDatagrams() == 0);
+    CHECK(syslog.queuedDatagrams() == 0);
+}
+
+int main() {
+    uint16_t port;
+    int fd = openListener(port);
+    testPendingMessagesAreSent(fd, port);
+    testFullDatagramsAndFlush(fd, port);
+    close(fd);
+    return testFailures;
+}
@@ -0,0 +1,42 @@
+// TeeLogging per-sink thresholds, including muted (None) sinks.
+
+#include "testing.h"
+#include <TeeLogging.h>
+
+class Counter : public LoggingBase {
+public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char*, size_t) override { ++lines; }
+    void writeln(const char*, size_t) override { ++lines; }
+    void log(LogLevel, const char*, size_t) override { ++lines; }
+    void logRecord(LogLevel, const uint8_t*, size_t) override { ++lines; }
+
+    int lines = 0;
+};
+
+int main() {
+    Counter info, muted;
+    TeeLogging tee;
+    CHECK(tee.addSink(info, LogLevel::Info));
+    CHECK(tee.addSink(muted, LogLevel::None));
+
+    tee.log(LogLevel::Warn, "w", 1);
+    tee.log(LogLevel::Debug, "d", 1);
+    tee.log(LogLevel::None, "n", 1);
+    const uint8_t record[] = { 0x83, 0x00, 0x60, 0xbf, 0xff };
+    tee.logRecord(LogLevel::None, record, sizeof(record));
+    tee.writeln("plain", 5);
+    CHECK(info.lines == 4);
+    CHECK(muted.lines == 0);
+
+    CHECK(tee.enabled(LogLevel::Info));
+    CHECK(!tee.enabled(LogLevel::Debug));
+    CHECK(tee.setSinkLevel(info, LogLevel::None));
+    CHECK(!tee.enabled(LogLevel::None));
+    CHECK(!tee.enabled(LogLevel::Error));
+    return testFailures;
+}
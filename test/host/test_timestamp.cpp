@@ -0,0 +1,59 @@
+// TimestampLogging: prefix per line, and long lines passed through uncut.
+
+#include "testing.h"
+#include <TimestampLogging.h>
+#include <string>
+#include <vector>
+
+class Capture : public LoggingBase {
+public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override { partial.append(data, len); }
+    void writeln(const char* data, size_t len) override {
+        lines.push_back(partial + std::string(data, len));
+        partial.clear();
+    }
+    void log(LogLevel level, const char* data, size_t len) override {
+        levels.push_back(level);
+        writeln(data, len);
+    }
+
+    std::vector<std::string> lines;
+    std::vector<LogLevel> levels;
+    std::string partial;
+};
+
+// "HH:MM:SS.mmm " followed by `text`.
+static bool stamped(const std::string& line, const std::string& text) {
+    if (line.size() != TimestampLogging::kPrefixLen + text.size()) return false;
+    const char* p = line.c_str();
+    return p[2] == ':' && p[5] == ':' && p[8] == '.' && p[12] == ' ' &&
+           line.compare(TimestampLogging::kPrefixLen, std::string::npos, text) == 0;
+}
+
+int main() {
+    Capture sink;
+    TimestampLogging stampedLog(sink);
+
+    stampedLog.write("a", 1);
+    stampedLog.write("b", 1);
+    stampedLog.writeln("c", 1);
+    CHECK(sink.lines.size() == 1 && stamped(sink.lines[0], "abc"));
+
+    std::string longLine(3 * LOGGING_LINE_BUFFER_SIZE, 'x');
+    longLine.back() = 'y';
+    stampedLog.writeln(longLine.c_str(), longLine.size());
+    CHECK(sink.lines.size() == 2 && stamped(sink.lines[1], longLine));
+
+    stampedLog.log(LogLevel::Warn, longLine.c_str(), longLine.size());
+    CHECK(sink.lines.size() == 3 && stamped(sink.lines[2], longLine));
+    CHECK(sink.levels.size() == 1 && sink.levels[0] == LogLevel::Warn);
+
+    stampedLog.log(LogLevel::Info, "short", 5);
+    CHECK(sink.lines.size() == 4 && stamped(sink.lines[3], "short"));
+    return testFailures;
+}
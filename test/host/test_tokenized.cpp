@@ -0,0 +1,75 @@
+// LOG_TOKENIZED record layout: long strings are cut to fit, not dropped.
+
+#include "testing.h"
+#include <TokenizedLogging.h>
+#include <string>
+#include <vector>
+
+class LastLine : public LoggingBase {
+public:
+    using LoggingBase::print;
+    using LoggingBase::println;
+
+    void print(const String& msg) override { write(msg.c_str(), msg.length()); }
+    void println(const String& msg) override { writeln(msg.c_str(), msg.length()); }
+    void write(const char* data, size_t len) override { line.assign(data, len); }
+    void writeln(const char* data, size_t len) override { line.assign(data, len); }
+
+    std::string line;
+};
+
+static std::vector<uint8_t> unbase64(const std::string& s) {
+    static const std::string chars =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::vector<uint8_t> out;
+    uint32_t v = 0;
+    int bits = 0;
+    for (char c : s) {
+        size_t i = chars.find(c);
+        if (i == std::string::npos) break;
+        v = v << 6 | (uint32_t)i;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back((uint8_t)(v >> bits));
+        }
+    }
+    return out;
+}
+
+static std::vector<uint8_t> record(const logtoken::Encoder& e) {
+    LastLine out;
+    e.emit(out);
+    CHECK(!out.line.empty() && out.line[0] == '$');
+    return unbase64(out.line.substr(1));
+}
+
+int main() {
+    std::string longText(100, 's');
+
+    // A string longer than the record is cut to the space left.
+    logtoken::Encoder a(0x11223344);
+    a.add(longText.c_str());
+    a.add(7);
+    std::vector<uint8_t> ra = record(a);
+    CHECK(ra.size() == TOKENIZED_LOG_MAX_PAYLOAD);
+    CHECK(ra[0] == 0x44 && ra[3] == 0x11);
+    CHECK(ra[4] == TOKENIZED_LOG_MAX_PAYLOAD - 5);
+    CHECK(std::string(ra.begin() + 5, ra.end()) == longText.substr(0, TOKENIZED_LOG_MAX_PAYLOAD - 5));
+
+    // After an integer the string gets what remains, with its length byte.
+    logtoken::Encoder b(1);
+    b.add(300);               // zig-zag 600: two varint bytes
+    b.add(longText.c_str());
+    std::vector<uint8_t> rb = record(b);
+    CHECK(rb.size() == TOKENIZED_LOG_MAX_PAYLOAD);
+    CHECK(rb[6] == TOKENIZED_LOG_MAX_PAYLOAD - 7);
+
+    // Short strings are kept whole and later arguments still follow.
+    logtoken::Encoder c(1);
+    c.add("hi");
+    c.add(-1);
+    std::vector<uint8_t> rc = record(c);
+    CHECK(rc.size() == 8 && rc[4] == 2 && rc[5] == 'h' && rc[6] == 'i' && rc[7] == 1);
+    return testFailures;
+}
@@ -0,0 +1,20 @@
+#ifndef HOST_TESTING_H
+#define HOST_TESTING_H
+
+// Minimal checks for the host tests: each test is one program that returns
+// the number of failed checks.
+
+#include <Arduino.h>
+
+HardwareSerial Serial;
+
+static int testFailures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++testFailures; \
+        } \
+    } while (0)
+
+#endif
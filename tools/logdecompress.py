@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Decompressor for CompressedLogging frames (see CompressedLogging.h).
+
+  logdecompress.py [capture.bin] [-o out.txt]     (stdin/stdout by default)
+
+Frames are located by their marker byte and checked by decoding them, so a
+capture that starts or ends mid-frame (e.g. a wrapped flash ring) loses only
+the cut frames. Ratio and frame counts are reported on stderr.
+"""
+import argparse
+import sys
+
+FRAME_COMPRESSED = 0xC5
+FRAME_STORED = 0xC4
+MIN_MATCH = 3
+
+
+def decompress_block(payload, raw_len):
+    """Returns the raw bytes, or None if the payload is not a valid block."""
+    out = bytearray()
+    i, n = 0, len(payload)
+    while i < n:
+        flags = payload[i]
+        i += 1
+        for bit in range(8):
+            if i >= n:
+                break
+            if flags & (1 << bit):
+                if i + 2 > n:
+                    return None
+                dist = payload[i] + 1
+                length = payload[i + 1] + MIN_MATCH
+                i += 2
+                if dist > len(out):
+                    return None
+                start = len(out) - dist
+                for k in range(length):  # may overlap the bytes being produced
+                    out.append(out[start + k])
+            else:
+                out.append(payload[i])
+                i += 1
+            if len(out) > raw_len:
+                return None
+    return bytes(out) if len(out) == raw_len else None
+
+
+def frames(data):
+    """Yields (raw bytes, frame size) for every valid frame; counts skipped bytes."""
+    pos, skipped = 0, 0
+    while pos + 5 <= len(data):
+        kind = data[pos]
+        if kind in (FRAME_COMPRESSED, FRAME_STORED):
+            raw_len = data[pos + 1] | data[pos + 2] << 8
+            size = data[pos + 3] | data[pos + 4] << 8
+            body = data[pos + 5:pos + 5 + size]
+            if len(body) == size:
+                if kind == FRAME_STORED:
+                    raw = bytes(body) if size == raw_len else None
+                else:
+                    raw = decompress_block(body, raw_len)
+                if raw is not None:
+                    yield raw, 5 + size, skipped
+                    skipped = 0
+                    pos += 5 + size
+                    continue
+        pos += 1
+        skipped += 1
+    frames.trailing = skipped + len(data) - pos
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument('capture', nargs='?', help='compressed stream (default: stdin)')
+    ap.add_argument('-o', '--output', help='decompressed text (default: stdout)')
+    args = ap.parse_args()
+
+    data = open(args.capture, 'rb').read() if args.capture else sys.stdin.buffer.read()
+    out = open(args.output, 'wb') if args.output else sys.stdout.buffer
+
+    count, raw_total, packed_total, skipped_total = 0, 0, 0, 0
+    for raw, size, skipped in frames(data):
+        out.write(raw)
+        count += 1
+        raw_total += len(raw)
+        packed_total += size
+        skipped_total += skipped
+    out.flush()
+    skipped_total += getattr(frames, 'trailing', 0)
+
+    ratio = raw_total / packed_total if packed_total else 0.0
+    sys.stderr.write('%d frames, %d -> %d bytes (ratio %.2f), %d bytes skipped\n'
+                     % (count, packed_total, raw_total, ratio, skipped_total))
+
+
+if __name__ == '__main__':
+    main()
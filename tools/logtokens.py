@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""Token database and decoder for LOG_TOKENIZED (see TokenizedLogging.h).
+
+  logtokens.py database <source files or dirs...>   > tokens.csv
+  logtokens.py decode tokens.csv [capture.txt]       (stdin if no file)
+
+Lines starting with '$' are decoded; all other lines pass through unchanged.
+"""
+import base64
+import csv
+import os
+import re
+import struct
+import sys
+
+SOURCE_EXTS = ('.h', '.hpp', '.c', '.cpp', '.cc', '.ino')
+CALL_RE = re.compile(r'\bLOG_TOKENIZED\s*\(\s*((?:"(?:[^"\\]|\\.)*"\s*)+)')
+LITERAL_RE = re.compile(r'"((?:[^"\\]|\\.)*)"')
+SPEC_RE = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t|L)?([diouxXcsfFeEgGaAp%])')
+# Conversions printed as unsigned; the device sends every integer as a signed
+# 64-bit varint, so negative values are wrapped back to the argument width.
+UNSIGNED_CONVS = 'ouxXp'
+ESCAPES = {'n': 10, 't': 9, 'r': 13, 'a': 7, 'b': 8, 'f': 12, 'v': 11,
+           '\\': 92, '"': 34, "'": 39, '?': 63}
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xffffffff
+    return h
+
+
+def unescape(s):
+    """C string literal body to the bytes the compiler emits (UTF-8 source)."""
+    out, i = bytearray(), 0
+    while i < len(s):
+        c = s[i]
+        if c == '\\' and i + 1 < len(s):
+            n = s[i + 1]
+            if n == 'x':
+                m = re.match(r'[0-9a-fA-F]+', s[i + 2:])
+                out.append(int(m.group(0), 16) & 0xff)
+                i += 2 + len(m.group(0))
+                continue
+            m = re.match(r'[0-7]{1,3}', s[i + 1:])
+            if m:
+                out.append(int(m.group(0), 8) & 0xff)
+                i += 1 + len(m.group(0))
+                continue
+            out.append(ESCAPES.get(n, ord(n) & 0xff))
+            i += 2
+            continue
+        out += c.encode('utf-8')
+        i += 1
+    return bytes(out)
+
+
+def source_files(paths):
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                for name in sorted(files):
+                    if name.endswith(SOURCE_EXTS):
+                        yield os.path.join(root, name)
+        else:
+            yield path
+
+
+def database(paths):
+    tokens = {}
+    for path in source_files(paths):
+        with open(path, encoding='utf-8', errors='replace') as f:
+            text = f.read()
+        for call in CALL_RE.finditer(text):
+            raw = b''.join(unescape(lit) for lit in LITERAL_RE.findall(call.group(1)))
+            raw = raw.split(b'\0', 1)[0]   # logtoken::hash stops at NUL too
+            token = fnv1a(raw)
+            # Bytes that are not UTF-8 (e.g. "\xff") are kept as \xNN text.
+            fmt = raw.decode('utf-8', 'backslashreplace')
+            if tokens.get(token, fmt) != fmt:
+                sys.stderr.write('token collision: %r vs %r\n' % (tokens[token], fmt))
+            tokens[token] = fmt
+    writer = csv.writer(sys.stdout, lineterminator='\n')
+    for token in sorted(tokens):
+        writer.writerow(['%08x' % token, tokens[token]])
+
+
+def read_varint(data, pos):
+    value = shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7f) << shift
+        shift += 7
+        if not b & 0x80:
+            return (value >> 1) ^ -(value & 1), pos
+
+
+def render(fmt, args):
+    out, pos, last = [], 0, 0
+    for spec in SPEC_RE.finditer(fmt):
+        out.append(fmt[last:spec.start()])
+        last = spec.end()
+        flags, length, conv = spec.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        try:
+            if conv == 's':
+                n = args[pos]
+                value = args[pos + 1:pos + 1 + n].decode('utf-8', 'replace')
+                pos += 1 + n
+            elif conv in 'fFeEgGaA':
+                value = struct.unpack_from('<f', args, pos)[0]
+                pos += 4
+                conv = 'f' if conv in 'aA' else conv
+            else:
+                value, pos = read_varint(args, pos)
+                bits = 64 if length in ('ll', 'j') else 32
+                if conv in UNSIGNED_CONVS and value < 0:
+                    value &= (1 << bits) - 1
+                if conv == 'c':
+                    value = chr(value & 0xff)
+                elif conv == 'p':
+                    conv, flags = 'x', '#' + flags
+                elif conv in 'iu':
+                    conv = 'd'
+            out.append(('%' + flags + conv) % value)
+        except (IndexError, struct.error):
+            out.append('<missing>')
+    out.append(fmt[last:])
+    return ''.join(out)
+
+
+def decode(db_path, stream):
+    with open(db_path, encoding='utf-8') as f:
+        tokens = {int(row[0], 16): row[1] for row in csv.reader(f) if row}
+    for line in stream:
+        text = line.rstrip('\r\n')
+        if not text.startswith('$'):
+            print(text)
+            continue
+        try:
+            record = base64.b64decode(text[1:], validate=True)
+            token = struct.unpack_from('<I', record)[0]
+        except (ValueError, struct.error):
+            print(text)
+            continue
+        fmt = tokens.get(token)
+        print(render(fmt, record[4:]) if fmt is not None else '<unknown token %08x> %s' % (token, text))
+
+
+def main(argv):
+    if len(argv) >= 3 and argv[1] == 'database':
+        database(argv[2:])
+    elif len(argv) in (3, 4) and argv[1] == 'decode':
+        if len(argv) == 4:
+            with open(argv[3], encoding='utf-8', errors='replace') as f:
+                decode(argv[2], f)
+        else:
+            decode(argv[2], sys.stdin)
+    else:
+        sys.stderr.write(__doc__)
+        return 2
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
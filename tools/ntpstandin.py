@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""Minimal NTP server for testing NtpTimeProvider on a host build.
+
+  ntpstandin.py [--port 12123] [--offset 2.5] [--drift-ppm 40] [--drop 0.1]
+
+Answers client requests with the host clock plus a fixed offset (seconds)
+and an optional rate error, so slewing, stepping and drift tracking can be
+exercised against localhost. --drop loses that fraction of replies.
+"""
+import argparse
+import random
+import socket
+import struct
+import time
+
+NTP_TO_UNIX = 2208988800
+
+
+def to_ntp(t):
+    s = int(t)
+    return ((s + NTP_TO_UNIX) << 32) | int((t - s) * (1 << 32))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument('--host', default='127.0.0.1')
+    ap.add_argument('--port', type=int, default=12123)
+    ap.add_argument('--offset', type=float, default=0.0, help='seconds added to the host clock')
+    ap.add_argument('--drift-ppm', type=float, default=0.0, help='rate error of the served clock')
+    ap.add_argument('--stratum', type=int, default=1)
+    ap.add_argument('--drop', type=float, default=0.0, help='fraction of requests left unanswered')
+    args = ap.parse_args()
+
+    start = time.time()
+
+    def served():
+        now = time.time()
+        return now + args.offset + (now - start) * args.drift_ppm * 1e-6
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.host, args.port))
+    print('serving on %s:%d' % (args.host, args.port), flush=True)
+    while True:
+        data, peer = sock.recvfrom(512)
+        t2 = served()
+        if len(data) < 48 or (data[0] & 7) != 3 or random.random() < args.drop:
+            continue
+        origin = data[40:48]
+        ref = to_ntp(served() - 16)
+        header = struct.pack('!BBbb', (4 << 3) | 4, args.stratum, 6, -20)
+        body = struct.pack('!II4sQ8sQ', 0, 0, b'LOCL', ref, origin, to_ntp(t2))
+        sock.sendto(header + body + struct.pack('!Q', to_ntp(served())), peer)
+
+
+if __name__ == '__main__':
+    main()